@@ -141,6 +141,7 @@ int main(int args, char *argv[])
     ("drop-function", boost::program_options::value<std::string>(), "Drop the function from the server.")
     ("show-unique-jobs", "Show unique jobs on server.")
     ("show-jobs", "Show all jobs on the server.")
+    ("show-hashtables", "Show job hash table statistics for the server.")
     ("getpid", "Get Process ID for the server.")
     ("status", "Status for the server.")
     ("priority-status", "Queued jobs status by priority.")
@@ -182,6 +183,7 @@ int main(int args, char *argv[])
      vm.count("cancel-job") == 0 and
      vm.count("show-unique-jobs") == 0 and
      vm.count("show-jobs") == 0 and
+     vm.count("show-hashtables") == 0 and
      vm.count("getpid") == 0 and
      vm.count("status") == 0 and
      vm.count("priority-status") == 0 and
@@ -236,6 +238,11 @@ int main(int args, char *argv[])
     instance.push(new util::Operation(util_literal_param("show jobs\r\n")));
   }
 
+  if (vm.count("show-hashtables"))
+  {
+    instance.push(new util::Operation(util_literal_param("show hashtables\r\n")));
+  }
+
   if (vm.count("drop-function"))
   {
     std::string execute(util_literal_param("drop function "));
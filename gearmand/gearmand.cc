@@ -121,6 +121,7 @@ int main(int argc, char *argv[])
   std::string config_file;
 
   uint32_t threads;
+  uint32_t proc_threads;
   bool opt_exceptions;
   bool opt_round_robin;
   bool opt_daemon;
@@ -158,7 +159,7 @@ int main(int argc, char *argv[])
    "Prefix used to generate a job handle string. If not provided, the default \"H:<host_name>\" is used.")
 
   ("hashtable-buckets", boost::program_options::value(&hashtable_buckets)->default_value(GEARMAND_DEFAULT_HASH_SIZE),
-   "Number of buckets in the internal job hash tables. The default of 991 works well for about three million jobs in queue. If the number of jobs in the queue at any time will exceed three million, use proportionally larger values (991 * # of jobs / 3M). For example, to accommodate 2^32 jobs, use 1733003. This will consume ~26MB of extra memory. Gearmand cannot support more than 2^32 jobs in queue at this time.")
+   "Initial number of buckets in the internal job hash tables. The tables grow as jobs are queued and never shrink below this size, so it only needs to be raised to avoid resizing while a large queue is loaded at startup.")
 
   ("keepalive", boost::program_options::bool_switch(&opt_keepalive)->default_value(false),
    "Enable keepalive on sockets.")
@@ -180,6 +181,9 @@ int main(int argc, char *argv[])
   ("pid-file,P", boost::program_options::value(&pid_file)->default_value(GEARMAND_PID),
    "File to write process ID out to.")
 
+  ("proc-threads", boost::program_options::value(&proc_threads)->default_value(1),
+   "Number of processing threads to use. Functions are spread over the processing threads by a hash of their name, so jobs for different functions can be run in parallel. Ignored when --threads is 0. Default=1.")
+
   ("protocol,r", boost::program_options::value(&protocol),
    "Load protocol module.")
 
@@ -317,6 +321,12 @@ int main(int argc, char *argv[])
     return EXIT_FAILURE;
   }
 
+  if (proc_threads <= 0)
+  {
+    error::message("proc-threads has to be greater than 0");
+    return EXIT_FAILURE;
+  }
+
   if (opt_check_args)
   {
     return EXIT_SUCCESS;
@@ -394,6 +404,8 @@ int main(int argc, char *argv[])
 
   gearmand_config_sockopt_keepalive_interval(gearmand_config, opt_keepalive_interval);
 
+  gearmand_config_proc_threads(gearmand_config, proc_threads);
+
   gearmand_st *_gearmand= gearmand_create(gearmand_config,
                                           host.empty() ? NULL : host.c_str(),
                                           threads, backlog,
@@ -47,6 +47,39 @@
 #include <cassert>
 #include <memory>
 
+/*
+ * Private definitions
+ */
+
+/**
+ * A job finishing in one shard removes its clients from connections that may
+ * be running in another, so the client list of a connection is protected by
+ * its thread lock once there is more than one shard.
+ */
+static void _server_client_con_lock(gearman_server_con_st *con)
+{
+  if (Server->shard_count > 1)
+  {
+    int pthread_error;
+    if ((pthread_error= pthread_mutex_lock(&(con->thread->lock))))
+    {
+      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_lock");
+    }
+  }
+}
+
+static void _server_client_con_unlock(gearman_server_con_st *con)
+{
+  if (Server->shard_count > 1)
+  {
+    int pthread_error;
+    if ((pthread_error= pthread_mutex_unlock(&(con->thread->lock))))
+    {
+      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_unlock");
+    }
+  }
+}
+
 /*
  * Public definitions
  */
@@ -56,7 +89,9 @@ gearman_server_client_add(gearman_server_con_st *con)
 {
   gearman_server_client_st *client;
 
-  if (Server->free_client_count > 0)
+  /* The free list is shared by every processing thread, so it is only used
+     when there is just the one. */
+  if (Server->shard_count == 1 and Server->free_client_count > 0)
   {
     client= Server->free_client_list;
     GEARMAND_LIST_DEL(Server->free_client, client, con_);
@@ -80,7 +115,9 @@ gearman_server_client_add(gearman_server_con_st *con)
 
   client->init(con);
 
+  _server_client_con_lock(con);
   GEARMAND_LIST_ADD(con->client, client, con_);
+  _server_client_con_unlock(con);
 
   return client;
 }
@@ -89,7 +126,9 @@ void gearman_server_client_free(gearman_server_client_st *client)
 {
   if (client)
   {
+    _server_client_con_lock(client->con);
     GEARMAND_LIST_DEL(client->con->client, client, con_);
+    _server_client_con_unlock(client->con);
 
     if (client->job)
     {
@@ -103,7 +142,7 @@ void gearman_server_client_free(gearman_server_client_st *client)
       }
     }
 
-    if (Server->free_client_count < GEARMAND_MAX_FREE_SERVER_CLIENT)
+    if (Server->shard_count == 1 and Server->free_client_count < GEARMAND_MAX_FREE_SERVER_CLIENT)
     {
       GEARMAND_LIST_ADD(Server->free_client, client, con_)
     }
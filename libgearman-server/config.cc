@@ -84,3 +84,11 @@ void gearmand_config_sockopt_keepalive_count(gearmand_config_st *config, int kee
     config->config.sockopt().keepalive_count(keepalive_count_);
   }
 }
+
+void gearmand_config_proc_threads(gearmand_config_st *config, uint32_t proc_threads_)
+{
+  if (config)
+  {
+    config->config.proc_threads(proc_threads_);
+  }
+}
@@ -65,6 +65,9 @@ GEARMAN_API
 GEARMAN_API
   void gearmand_config_sockopt_keepalive_count(gearmand_config_st *config, int keepalive_count_);
 
+GEARMAN_API
+  void gearmand_config_proc_threads(gearmand_config_st *config, uint32_t proc_threads_);
+
 #ifdef __cplusplus
 }
 #endif
@@ -45,7 +45,8 @@ namespace gearmand {
 class Config
 {
 public:
-  Config()
+  Config():
+    _proc_threads(1)
   {
   }
 
@@ -54,8 +55,20 @@ public:
     return _sockopt;
   }
 
+  // Number of processing threads, each one owns a shard of the functions.
+  uint32_t proc_threads() const
+  {
+    return _proc_threads;
+  }
+
+  void proc_threads(uint32_t proc_threads_)
+  {
+    _proc_threads= proc_threads_ ? proc_threads_ : 1;
+  }
+
 private:
   gearmand_st::SocketOpt _sockopt;
+  uint32_t _proc_threads;
 };
 
 } //namespace gearmand
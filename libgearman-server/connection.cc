@@ -139,6 +139,7 @@ static gearman_server_con_st * _server_con_create(gearman_server_thread_st *thre
   con->io_prev= NULL;
   con->proc_next= NULL;
   con->proc_prev= NULL;
+  con->proc_shard= NULL;
   con->to_be_freed_next= NULL;
   con->to_be_freed_prev= NULL;
   con->worker_list= NULL;
@@ -473,25 +474,27 @@ void gearman_server_con_io_add(gearman_server_con_st *con)
   int lock_error;
   if ((lock_error= pthread_mutex_lock(&con->thread->lock)) == 0)
   {
-    GEARMAND_LIST_ADD(con->thread->io, con, io_);
-    con->io_list= true;
+    bool run= false;
 
-    /* Looks funny, but need to check io_count locked, but call run unlocked. */
-    if (con->thread->io_count == 1 && con->thread->run_fn)
+    /* Check again now that it is locked, more than one processing thread
+       may be sending to the same connection. */
+    if (con->io_list == false)
     {
-      if ((lock_error= pthread_mutex_unlock(&con->thread->lock)))
-      {
-        gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, lock_error, "pthread_mutex_unlock");
-      }
+      GEARMAND_LIST_ADD(con->thread->io, con, io_);
+      con->io_list= true;
 
-      (*con->thread->run_fn)(con->thread, con->thread->run_fn_arg);
+      /* Looks funny, but need to check io_count locked, but call run unlocked. */
+      run= (con->thread->io_count == 1 && con->thread->run_fn);
     }
-    else
+
+    if ((lock_error= pthread_mutex_unlock(&con->thread->lock)))
     {
-      if ((lock_error= pthread_mutex_unlock(&con->thread->lock)))
-      {
-        gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, lock_error, "pthread_mutex_unlock");
-      }
+      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, lock_error, "pthread_mutex_unlock");
+    }
+
+    if (run)
+    {
+      (*con->thread->run_fn)(con->thread, con->thread->run_fn_arg);
     }
   }
   else
@@ -538,50 +541,76 @@ gearman_server_con_io_next(gearman_server_thread_st *thread)
   return con;
 }
 
-void gearman_server_con_proc_add(gearman_server_con_st *con)
+/**
+ * Put a connection on the run list of a shard and wake the shard up.
+ */
+static void _server_con_proc_push(gearman_server_shard_st *shard,
+                                  gearman_server_con_st *con)
 {
-  if (con->proc_list)
+  int pthread_error;
+  if ((pthread_error= pthread_mutex_lock(&(shard->proc_lock))) == 0)
   {
-    return;
+    GEARMAND_LIST_ADD(shard->con, con, proc_);
+    con->proc_shard= shard;
+
+    if (! (Server->proc_shutdown) && !(shard->proc_wakeup))
+    {
+      shard->proc_wakeup= true;
+      if ((pthread_error= pthread_cond_signal(&(shard->proc_cond))))
+      {
+        gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_cond_signal");
+      }
+    }
+
+    if ((pthread_error= pthread_mutex_unlock(&(shard->proc_lock))))
+    {
+      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_unlock");
+    }
+  }
+  else
+  {
+    gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_lock");
   }
+}
+
+void gearman_server_con_proc_add(gearman_server_con_st *con)
+{
+  gearman_server_shard_st *shard= NULL;
 
   int pthread_error;
   if ((pthread_error= pthread_mutex_lock(&con->thread->lock)) == 0)
   {
-    GEARMAND_LIST_ADD(con->thread->proc, con, proc_);
-    con->proc_list= true;
-    if ((pthread_error= pthread_mutex_unlock(&con->thread->lock)))
+    /* If a shard is already running the connection it will see the new
+       packets before it lets go of it. */
+    if (con->proc_list == false)
     {
-      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_unlock");
-    }
+      con->proc_list= true;
 
-    if (! (Server->proc_shutdown) && !(Server->proc_wakeup))
-    {
-      if ((pthread_error= pthread_mutex_lock(&(Server->proc_lock))) == 0)
+      bool cross_shard;
+      if (con->proc_packet_list)
       {
-        Server->proc_wakeup= true;
-        if ((pthread_error= pthread_cond_signal(&(Server->proc_cond))) == 0)
-        {
-          if ((pthread_error= pthread_mutex_unlock(&(Server->proc_lock))))
-          {
-            gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_unlock");
-          }
-        }
-        else
-        {
-          gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_cond_signal");
-        }
+        shard= gearman_server_shard_route(Server, con, &(con->proc_packet_list->packet), NULL, &cross_shard);
       }
       else
       {
-        gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_lock");
+        shard= Server->shard_list;
       }
     }
+
+    if ((pthread_error= pthread_mutex_unlock(&con->thread->lock)))
+    {
+      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_unlock");
+    }
   }
   else
   {
     gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_lock");
   }
+
+  if (shard)
+  {
+    _server_con_proc_push(shard, con);
+  }
 }
 
 void gearman_server_con_proc_remove(gearman_server_con_st *con)
@@ -590,11 +619,24 @@ void gearman_server_con_proc_remove(gearman_server_con_st *con)
 
   if ((pthread_error= pthread_mutex_lock(&con->thread->lock)) == 0)
   {
-    if (con->proc_list)
+    gearman_server_shard_st *shard= con->proc_shard;
+    if (shard)
     {
-      GEARMAND_LIST_DEL(con->thread->proc, con, proc_);
-      con->proc_list= false;
+      if ((pthread_error= pthread_mutex_lock(&(shard->proc_lock))) == 0)
+      {
+        GEARMAND_LIST_DEL(shard->con, con, proc_);
+        con->proc_shard= NULL;
+        if ((pthread_error= pthread_mutex_unlock(&(shard->proc_lock))))
+        {
+          gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_unlock");
+        }
+      }
+      else
+      {
+        gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_lock");
+      }
     }
+    con->proc_list= false;
 
     if ((pthread_error= pthread_mutex_unlock(&con->thread->lock)))
     {
@@ -608,9 +650,9 @@ void gearman_server_con_proc_remove(gearman_server_con_st *con)
 }
 
 gearman_server_con_st *
-gearman_server_con_proc_next(gearman_server_thread_st *thread)
+gearman_server_con_proc_next(gearman_server_shard_st *shard)
 {
-  if (thread->proc_list == NULL)
+  if (shard->con_list == NULL)
   {
     return NULL;
   }
@@ -618,21 +660,65 @@ gearman_server_con_proc_next(gearman_server_thread_st *thread)
   gearman_server_con_st *con= NULL;
 
   int pthread_error;
-  if ((pthread_error= pthread_mutex_lock(&thread->lock)) == 0)
+  if ((pthread_error= pthread_mutex_lock(&(shard->proc_lock))) == 0)
   {
-    con= thread->proc_list;
-    while (con != NULL)
+    con= shard->con_list;
+    if (con != NULL)
     {
-      GEARMAND_LIST_DEL(thread->proc, con, proc_);
-      con->proc_list= false;
-      if (!(con->proc_removed))
+      GEARMAND_LIST_DEL(shard->con, con, proc_);
+      con->proc_shard= NULL;
+    }
+
+    if ((pthread_error= pthread_mutex_unlock(&(shard->proc_lock))))
+    {
+      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_unlock");
+    }
+  }
+  else
+  {
+    gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_lock");
+  }
+
+  return con;
+}
+
+gearman_server_packet_st *
+gearman_server_con_proc_take(gearman_server_shard_st *shard,
+                             gearman_server_con_st *con,
+                             bool *cross_shard,
+                             bool *is_dead)
+{
+  gearman_server_packet_st *packet= NULL;
+  gearman_server_shard_st *owner= shard;
+  *cross_shard= false;
+  *is_dead= false;
+
+  int pthread_error;
+  if ((pthread_error= pthread_mutex_lock(&con->thread->lock)) == 0)
+  {
+    packet= con->proc_packet_list;
+    if (packet)
+    {
+      owner= gearman_server_shard_route(Server, con, &(packet->packet), shard, cross_shard);
+      if (owner == shard)
       {
-        break;
+        GEARMAND_FIFO__DEL(con->proc_packet, packet);
       }
-      con= thread->proc_list;
+      else
+      {
+        packet= NULL;
+      }
+    }
+    else if (con->is_dead and con->proc_removed == false)
+    {
+      *is_dead= true;
+    }
+    else
+    {
+      con->proc_list= false;
     }
 
-    if ((pthread_error= pthread_mutex_unlock(&thread->lock)))
+    if ((pthread_error= pthread_mutex_unlock(&con->thread->lock)))
     {
       gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_unlock");
     }
@@ -642,7 +728,32 @@ gearman_server_con_proc_next(gearman_server_thread_st *thread)
     gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_lock");
   }
 
-  return con;
+  if (owner != shard)
+  {
+    _server_con_proc_push(owner, con);
+  }
+
+  return packet;
+}
+
+void gearman_server_con_proc_removed(gearman_server_con_st *con)
+{
+  int pthread_error;
+  if ((pthread_error= pthread_mutex_lock(&con->thread->lock)) == 0)
+  {
+    con->proc_removed= true;
+    con->proc_list= false;
+    if ((pthread_error= pthread_mutex_unlock(&con->thread->lock)))
+    {
+      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_unlock");
+    }
+  }
+  else
+  {
+    gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_lock");
+  }
+
+  gearman_server_con_to_be_freed_add(con);
 }
 
 static void _server_job_timeout(int fd, short event, void *arg)
@@ -656,6 +767,11 @@ static void _server_job_timeout(int fd, short event, void *arg)
                        "Worker timeout reached on job, requeueing: %s %s",
                        job->job_handle, job->unique);
 
+  /* The timer fires in the I/O thread, so take the lock of the shard that
+     owns the job before touching it. */
+  gearman_server_shard_st *shard= job->function->shard;
+  gearman_server_shard_lock(shard);
+
   gearmand_error_t ret= gearman_server_job_queue(job);
   if (ret != GEARMAND_SUCCESS)
   {
@@ -664,6 +780,8 @@ static void _server_job_timeout(int fd, short event, void *arg)
                        job->job_handle, job->unique);
     gearman_server_job_free(job);
   }
+
+  gearman_server_shard_unlock(shard);
 }
 
 gearmand_error_t gearman_server_con_add_job_timeout(gearman_server_con_st *con, gearman_server_job_st *job)
@@ -161,23 +161,45 @@ gearman_server_con_st *
 gearman_server_con_io_next(gearman_server_thread_st *thread);
 
 /**
- * Add connection to the proc thread list.
+ * Hand a connection with queued packets to the shard that owns its first
+ * packet, unless a shard is already running it.
  */
 GEARMAN_API
 void gearman_server_con_proc_add(gearman_server_con_st *con);
 
 /**
- * Remove connection from the proc thread list.
+ * Remove connection from the run list of its shard.
  */
 GEARMAN_API
 void gearman_server_con_proc_remove(gearman_server_con_st *con);
 
 /**
- * Get next connection from the proc thread list.
+ * Get next connection from the run list of a shard.
  */
 GEARMAN_API
 gearman_server_con_st *
-gearman_server_con_proc_next(gearman_server_thread_st *thread);
+gearman_server_con_proc_next(gearman_server_shard_st *shard);
+
+/**
+ * Take the next packet of a connection that a shard is running. NULL is
+ * returned once the shard must stop running the connection: either nothing
+ * is left and the connection was released, or the next packet belongs to
+ * another shard and the connection was handed over to it. If nothing is left
+ * and the connection is dead, is_dead is set and the shard keeps the
+ * connection so it can be cleaned up with gearman_server_con_proc_removed().
+ */
+GEARMAN_API
+gearman_server_packet_st *
+gearman_server_con_proc_take(gearman_server_shard_st *shard,
+                             gearman_server_con_st *con,
+                             bool *cross_shard,
+                             bool *is_dead);
+
+/**
+ * Release a dead connection whose workers and clients have been freed.
+ */
+GEARMAN_API
+void gearman_server_con_proc_removed(gearman_server_con_st *con);
 
 /**
  * Set protocol context pointer.
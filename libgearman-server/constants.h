@@ -100,6 +100,7 @@ enum gearmand_connection_options_t
 
 struct gearman_server_thread_st;
 struct gearman_server_st;
+struct gearman_server_shard_st;
 struct gearman_server_con_st;
 struct gearmand_io_st;
 
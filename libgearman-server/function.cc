@@ -51,7 +51,7 @@
  * Public definitions
  */
 
-static uint32_t _server_function_hash(const char *name, size_t size)
+uint32_t _server_function_hash(const char *name, size_t size)
 {
   const char *ptr= name;
   int32_t value= 0;
@@ -74,7 +74,7 @@ static uint32_t _server_function_hash(const char *name, size_t size)
 #ifndef __INTEL_COMPILER
 # pragma GCC diagnostic ignored "-Wold-style-cast"
 #endif
-static gearman_server_function_st* gearman_server_function_create(gearman_server_st *server,
+static gearman_server_function_st* gearman_server_function_create(gearman_server_shard_st *shard,
                                                                   const char *function_name,
                                                                   size_t function_name_size,
                                                                   uint32_t function_key)
@@ -104,12 +104,13 @@ static gearman_server_function_st* gearman_server_function_create(gearman_server
   memcpy(function->function_name, function_name, function_name_size);
   function->function_name[function_name_size]= 0;
   function->function_name_size= function_name_size;
+  function->shard= shard;
   function->worker_list= NULL;
   memset(function->job_list, 0,
          sizeof(gearman_server_job_st *) * GEARMAN_JOB_PRIORITY_MAX);
   memset(function->job_end, 0,
          sizeof(gearman_server_job_st *) * GEARMAN_JOB_PRIORITY_MAX);
-  GEARMAND_HASH__ADD(server->function, function_key, function);
+  GEARMAND_HASH__ADD(shard->function, function_key, function);
   return function;
 }
 
@@ -119,9 +120,10 @@ gearman_server_function_get(gearman_server_st *server,
                             size_t function_name_size)
 {
   gearman_server_function_st *function;
+  gearman_server_shard_st *shard= gearman_server_shard_by_function(server, function_name, function_name_size);
 
   uint32_t function_hash = _server_function_hash(function_name, function_name_size) % GEARMAND_DEFAULT_HASH_SIZE;
-  for (function= server->function_hash[function_hash]; function != NULL;
+  for (function= shard->function_hash[function_hash]; function != NULL;
        function= function->next)
   {
     if (function->function_name_size == function_name_size and
@@ -131,15 +133,16 @@ gearman_server_function_get(gearman_server_st *server,
     }
   }
 
-  return gearman_server_function_create(server, function_name, function_name_size, function_hash);
+  return gearman_server_function_create(shard, function_name, function_name_size, function_hash);
 }
 
-void gearman_server_function_free(gearman_server_st *server, gearman_server_function_st *function)
+void gearman_server_function_free(gearman_server_st *, gearman_server_function_st *function)
 {
+  gearman_server_shard_st *shard= function->shard;
   uint32_t function_key;
   function_key= _server_function_hash(function->function_name, function->function_name_size);
   function_key= function_key % GEARMAND_DEFAULT_HASH_SIZE;
-  GEARMAND_HASH__DEL(server->function, function_key, function);
+  GEARMAND_HASH__DEL(shard->function, function_key, function);
   delete [] function->function_name;
   delete function;
 }
@@ -59,6 +59,11 @@ extern "C" {
  * @{
  */
 
+/**
+  Hash a function name, used both for the registry and to pick the shard.
+ */
+uint32_t _server_function_hash(const char *name, size_t size);
+
 /** 
   Add a new function to a server instance.
  */
@@ -118,7 +118,8 @@ static bool gearman_server_create(gearman_server_st& server,
                                   const char *job_handle_prefix,
                                   uint8_t worker_wakeup,
                                   bool round_robin,
-                                  uint32_t hashtable_buckets);
+                                  uint32_t hashtable_buckets,
+                                  uint32_t proc_threads);
 static void gearmand_set_log_fn(gearmand_st *gearmand, gearmand_log_fn *function,
                                 void *context, const gearmand_verbose_t verbose);
 
@@ -128,22 +129,39 @@ static void gearman_server_free(gearman_server_st& server)
   /* All threads should be cleaned up before calling this. */
   assert(server.thread_list == NULL);
 
-  for (uint32_t key= 0; key < server.hashtable_buckets; key++)
+  for (uint32_t shard_key= 0; shard_key < server.shard_count; shard_key++)
   {
-    while (server.job_hash[key] != NULL)
+    gearman_server_job_table_st *table= &(server.shard_list[shard_key].job_table);
+
+    /* Keep jobs from moving between buckets while the table is emptied. */
+    gearman_server_job_table_pause(table);
+    gearman_server_job_table_pause(&(server.shard_list[shard_key].unique_table));
+    for (uint32_t array= 0; array < 2; array++)
     {
-      gearman_server_save_job(server, server.job_hash[key]);
-      gearman_server_job_free(server.job_hash[key]);
+      for (uint32_t key= 0; table->bucket[array] and key < table->size[array]; key++)
+      {
+        while (table->bucket[array][key] != NULL)
+        {
+          gearman_server_save_job(server, table->bucket[array][key]);
+          gearman_server_job_free(table->bucket[array][key]);
+        }
+      }
     }
+    gearman_server_job_table_resume(&(server.shard_list[shard_key].unique_table));
+    gearman_server_job_table_resume(table);
   }
   gearman_queue_flush(&server);
 
-  for (uint32_t function_key= 0; function_key < GEARMAND_DEFAULT_HASH_SIZE;
-       function_key++)
+  for (uint32_t shard_key= 0; shard_key < server.shard_count; shard_key++)
   {
-    while(server.function_hash[function_key] != NULL)
+    gearman_server_shard_st *shard= &server.shard_list[shard_key];
+    for (uint32_t function_key= 0; function_key < GEARMAND_DEFAULT_HASH_SIZE;
+         function_key++)
     {
-      gearman_server_function_free(&server, server.function_hash[function_key]);
+      while(shard->function_hash[function_key] != NULL)
+      {
+        gearman_server_function_free(&server, shard->function_hash[function_key]);
+      }
     }
   }
 
@@ -154,13 +172,6 @@ static void gearman_server_free(gearman_server_st& server)
     delete packet;
   }
 
-  while (server.free_job_list != NULL)
-  {
-    gearman_server_job_st* job= server.free_job_list;
-    server.free_job_list= job->next;
-    delete job;
-  }
-
   while (server.free_client_list != NULL)
   {
     gearman_server_client_st* client= server.free_client_list;
@@ -168,13 +179,6 @@ static void gearman_server_free(gearman_server_st& server)
     delete client;
   }
 
-  while (server.free_worker_list != NULL)
-  {
-    gearman_server_worker_st* worker= server.free_worker_list;
-    server.free_worker_list= worker->con_next;
-    delete worker;
-  }
-
   gearmand_log_debug(GEARMAN_DEFAULT_LOG_PARAM, "removing queue: %s", (server.queue_version == QUEUE_VERSION_CLASS) ? "CLASS" : "FUNCTION");
   if (server.queue_version == QUEUE_VERSION_CLASS)
   {
@@ -191,9 +195,8 @@ static void gearman_server_free(gearman_server_st& server)
     gearmand_debug("Unknown queue type in removal");
   }
 
-  free(server.job_hash);
-  free(server.unique_hash);
-  free(server.function_hash);
+  gearman_server_shard_free(&server);
+  pthread_mutex_destroy(&(server.queue_lock));
 }
 
 /** @} */
@@ -251,7 +254,8 @@ gearmand_st *gearmand_create(gearmand_config_st *config,
 
   if (gearman_server_create(gearmand->server, job_retries,
                             job_handle_prefix, worker_wakeup,
-                            round_robin, hashtable_buckets) == false)
+                            round_robin, hashtable_buckets,
+                            threads_arg ? config->config.proc_threads() : 1) == false)
   {
     delete gearmand;
     _global_gearmand= NULL;
@@ -1199,54 +1203,39 @@ static bool gearman_server_create(gearman_server_st& server,
                                   const char *job_handle_prefix,
                                   uint8_t worker_wakeup_arg,
                                   bool round_robin_arg,
-                                  uint32_t hashtable_buckets)
+                                  uint32_t hashtable_buckets,
+                                  uint32_t proc_threads)
 {
   server.state.queue_startup= false;
   server.flags.round_robin= round_robin_arg;
   server.flags.threaded= false;
   server.shutdown= false;
   server.shutdown_graceful= false;
-  server.proc_wakeup= false;
   server.proc_shutdown= false;
   server.job_retries= job_retries_arg;
   server.worker_wakeup= worker_wakeup_arg;
   server.thread_count= 0;
   server.free_packet_count= 0;
-  server.function_count= 0;
-  server.job_count= 0;
-  server.unique_count= 0;
-  server.free_job_count= 0;
   server.free_client_count= 0;
-  server.free_worker_count= 0;
   server.thread_list= NULL;
   server.free_packet_list= NULL;
-  server.free_job_list= NULL;
   server.free_client_list= NULL;
-  server.free_worker_list= NULL;
 
   server.queue_version= QUEUE_VERSION_NONE;
   server.queue.object= NULL;
   server.queue.functions= NULL;
 
-  server.function_hash= (gearman_server_function_st **) calloc(GEARMAND_DEFAULT_HASH_SIZE, sizeof(gearman_server_function_st *));
-  if (server.function_hash == NULL)
+  int pthread_error;
+  if ((pthread_error= pthread_mutex_init(&(server.queue_lock), NULL)))
   {
-    gearmand_merror("calloc", server.function_hash, GEARMAND_DEFAULT_HASH_SIZE);
+    gearmand_perror(pthread_error, "pthread_mutex_init");
     return false;
   }
 
   server.hashtable_buckets= hashtable_buckets;
-  server.job_hash= (gearman_server_job_st **) calloc(hashtable_buckets, sizeof(gearman_server_job_st *));
-  if (server.job_hash == NULL)
+  if (gearman_server_shard_create(&server, proc_threads, hashtable_buckets) == false)
   {
-    gearmand_merror("calloc", server.job_hash, hashtable_buckets);
-    return false;
-  }
-
-  server.unique_hash= (gearman_server_job_st **) calloc(hashtable_buckets, sizeof(gearman_server_job_st *));
-  if (server.unique_hash == NULL)
-  {
-    gearmand_merror("calloc", server.unique_hash, hashtable_buckets);
+    gearman_server_free(server);
     return false;
   }
 
@@ -1275,8 +1264,6 @@ static bool gearman_server_create(gearman_server_st& server,
     return false;
   }
 
-  server.job_handle_count= 1;
-
   return true;
 }
 
@@ -68,8 +68,10 @@
 #include <libgearman-server/client.h>
 #include <libgearman-server/worker.h>
 #include <libgearman-server/job.h>
+#include <libgearman-server/job_table.h>
 #include <libgearman-server/thread.h>
 #include <libgearman-server/server.h>
+#include <libgearman-server/shard.h>
 #include <libgearman-server/gearmand_thread.h>
 #include <libgearman-server/gearmand_con.h>
 
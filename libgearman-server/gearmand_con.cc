@@ -201,26 +201,32 @@ gearman_server_job_st *gearman_server_job_get_by_unique(gearman_server_st *serve
                                                         gearman_server_con_st *worker_con)
 {
   uint32_t key= _server_job_hash(unique, unique_length);
-  gearman_server_job_st *server_job;
 
-  for (server_job= server->unique_hash[key % server->hashtable_buckets];
-       server_job != NULL; server_job= server_job->unique_next)
+  /* The unique is not tied to a function, so every shard has to be searched. */
+  for (uint32_t x= 0; x < server->shard_count; ++x)
   {
-    gearmand_log_debug(GEARMAN_DEFAULT_LOG_PARAM, "COMPARE unique \"%s\"(%u) == \"%s\"(%u)",
-                       bool(server_job->unique[0]) ? server_job->unique :  "<null>", uint32_t(strlen(server_job->unique)),
-                       unique, uint32_t(unique_length));
-
-    if (bool(server_job->unique[0]) and
-        (strcmp(server_job->unique, unique) == 0))
+    for (uint32_t array= 0; array < 2; ++array)
     {
-      /* Check to make sure the worker asking for the job still owns the job. */
-      if (worker_con != NULL and
-          (server_job->worker == NULL or server_job->worker->con != worker_con))
+      for (gearman_server_job_st *server_job= gearman_server_job_table_bucket(&(server->shard_list[x].unique_table), key, array);
+           server_job != NULL; server_job= server_job->unique_next)
       {
-        return NULL;
-      }
+        gearmand_log_debug(GEARMAN_DEFAULT_LOG_PARAM, "COMPARE unique \"%s\"(%u) == \"%s\"(%u)",
+                           bool(server_job->unique[0]) ? server_job->unique :  "<null>", uint32_t(strlen(server_job->unique)),
+                           unique, uint32_t(unique_length));
+
+        if (bool(server_job->unique[0]) and
+            (strcmp(server_job->unique, unique) == 0))
+        {
+          /* Check to make sure the worker asking for the job still owns the job. */
+          if (worker_con != NULL and
+              (server_job->worker == NULL or server_job->worker->con != worker_con))
+          {
+            return NULL;
+          }
 
-      return server_job;
+          return server_job;
+        }
+      }
     }
   }
 
@@ -233,21 +239,25 @@ gearman_server_job_st *gearman_server_job_get(gearman_server_st *server,
                                               gearman_server_con_st *worker_con)
 {
   uint32_t key= _server_job_hash(job_handle, job_handle_length);
+  gearman_server_shard_st *shard= gearman_server_shard_by_job_handle(server, job_handle, job_handle_length);
 
-  for (gearman_server_job_st *server_job= server->job_hash[key % server->hashtable_buckets];
-       server_job != NULL; server_job= server_job->next)
+  for (uint32_t array= 0; array < 2; ++array)
   {
-    if (server_job->job_handle_key == key and
-        strncmp(server_job->job_handle, job_handle, GEARMAND_JOB_HANDLE_SIZE) == 0)
+    for (gearman_server_job_st *server_job= gearman_server_job_table_bucket(&(shard->job_table), key, array);
+         server_job != NULL; server_job= server_job->next)
     {
-      /* Check to make sure the worker asking for the job still owns the job. */
-      if (worker_con != NULL and
-          (server_job->worker == NULL or server_job->worker->con != worker_con))
+      if (server_job->job_handle_key == key and
+          strncmp(server_job->job_handle, job_handle, GEARMAND_JOB_HANDLE_SIZE) == 0)
       {
-        return NULL;
-      }
+        /* Check to make sure the worker asking for the job still owns the job. */
+        if (worker_con != NULL and
+            (server_job->worker == NULL or server_job->worker->con != worker_con))
+        {
+          return NULL;
+        }
 
-      return server_job;
+        return server_job;
+      }
     }
   }
 
@@ -259,51 +269,45 @@ gearmand_error_t gearman_server_job_cancel(gearman_server_st& server,
                                            const size_t job_handle_length)
 {
   gearmand_error_t ret= GEARMAND_NO_JOBS;
-  uint32_t key= _server_job_hash(job_handle, job_handle_length);
 
   gearmand_log_debug(GEARMAN_DEFAULT_LOG_PARAM, "cancel: %.*s", int(job_handle_length), job_handle);
 
-  for (gearman_server_job_st *server_job= server.job_hash[key % server.hashtable_buckets];
-       server_job != NULL;
-       server_job= server_job->next)
+  gearman_server_job_st *server_job= gearman_server_job_get(&server, job_handle, job_handle_length, NULL);
+  if (server_job)
   {
-    if (server_job->job_handle_key == key and
-        strncmp(server_job->job_handle, job_handle, GEARMAND_JOB_HANDLE_SIZE) == 0)
+    /* Queue the fail packet for all clients. */
+    for (gearman_server_client_st* client= server_job->client_list; client != NULL; client= client->job_next)
     {
-      /* Queue the fail packet for all clients. */
-      for (gearman_server_client_st* client= server_job->client_list; client != NULL; client= client->job_next)
+      ret= gearman_server_io_packet_add(client->con, false,
+                                        GEARMAN_MAGIC_RESPONSE,
+                                        GEARMAN_COMMAND_WORK_FAIL,
+                                        server_job->job_handle,
+                                        (size_t)strlen(server_job->job_handle),
+                                        NULL);
+      if (gearmand_failed(ret))
       {
-        ret= gearman_server_io_packet_add(client->con, false,
-                                          GEARMAN_MAGIC_RESPONSE,
-                                          GEARMAN_COMMAND_WORK_FAIL,
-                                          server_job->job_handle,
-                                          (size_t)strlen(server_job->job_handle),
-                                          NULL);
-        if (gearmand_failed(ret))
-        {
-          gearmand_log_gerror_warn(GEARMAN_DEFAULT_LOG_PARAM, ret, "Failed to send WORK_FAIL packet to %s:%s", client->con->host(), client->con->port());
-        }
+        gearmand_log_gerror_warn(GEARMAN_DEFAULT_LOG_PARAM, ret, "Failed to send WORK_FAIL packet to %s:%s", client->con->host(), client->con->port());
       }
+    }
 
-      /* Remove from persistent queue if one exists. */
-      if (server_job->job_queued)
+    /* Remove from persistent queue if one exists. */
+    if (server_job->job_queued)
+    {
+      ret= gearman_queue_done(Server,
+                              server_job->unique,
+                              server_job->unique_length,
+                              server_job->function->function_name,
+                              server_job->function->function_name_size);
+      if (gearmand_failed(ret))
       {
-        ret= gearman_queue_done(Server,
-                                server_job->unique,
-                                server_job->unique_length,
-                                server_job->function->function_name,
-                                server_job->function->function_name_size);
-        if (gearmand_failed(ret))
-        {
-          return gearmand_gerror("Remove from persistent queue", ret);
-        }
+        return gearmand_gerror("Remove from persistent queue", ret);
       }
+    }
 
-      server_job->ignore_job= true;
-      server_job->job_queued= false;
+    server_job->ignore_job= true;
+    server_job->job_queued= false;
 
-      return GEARMAND_SUCCESS;
-    }
+    return GEARMAND_SUCCESS;
   }
 
   return ret;
@@ -439,94 +443,116 @@ gearman_server_job_st *gearman_server_job_take(gearman_server_con_st *server_con
 
 void *_proc(void *data)
 {
-  gearman_server_st *server= (gearman_server_st *)data;
+  gearman_server_shard_st *shard= (gearman_server_shard_st *)data;
 
-  (void)gearmand_initialize_thread_logging("[  proc ]");
+  if (Server->shard_count == 1)
+  {
+    (void)gearmand_initialize_thread_logging("[  proc ]");
+  }
+  else
+  {
+    char identity[BUFSIZ];
+    snprintf(identity, sizeof(identity), "[proc %3u]", shard->index);
+    (void)gearmand_initialize_thread_logging(identity);
+  }
 
   while (1)
   {
     int pthread_error;
-    if ((pthread_error= pthread_mutex_lock(&(server->proc_lock))))
+    if ((pthread_error= pthread_mutex_lock(&(shard->proc_lock))))
     {
       gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_lock");
       return NULL;
     }
 
-    while (server->proc_wakeup == false)
+    while (shard->proc_wakeup == false)
     {
-      if (server->proc_shutdown)
+      if (Server->proc_shutdown)
       {
-        if ((pthread_error= pthread_mutex_unlock(&(server->proc_lock))))
+        if ((pthread_error= pthread_mutex_unlock(&(shard->proc_lock))))
         {
           gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_unlock");
         }
         return NULL;
       }
 
-      (void) pthread_cond_wait(&(server->proc_cond), &(server->proc_lock));
+      (void) pthread_cond_wait(&(shard->proc_cond), &(shard->proc_lock));
     }
-    server->proc_wakeup= false;
+    shard->proc_wakeup= false;
 
     {
-      if ((pthread_error= pthread_mutex_unlock(&(server->proc_lock))))
+      if ((pthread_error= pthread_mutex_unlock(&(shard->proc_lock))))
       {
         gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_unlock");
       }
     }
 
-    for (gearman_server_thread_st *thread= server->thread_list; thread != NULL; thread= thread->next)
+    gearman_server_con_st *con;
+    while ((con= gearman_server_con_proc_next(shard)) != NULL)
     {
-      gearman_server_con_st *con;
-      while ((con= gearman_server_con_proc_next(thread)) != NULL)
+      while (1)
       {
-        bool packet_sent = false;
-        while (1)
+        bool cross_shard;
+        bool is_dead;
+        gearman_server_packet_st *packet= gearman_server_con_proc_take(shard, con, &cross_shard, &is_dead);
+        if (packet)
         {
-          gearman_server_packet_st *packet= gearman_server_proc_packet_remove(con);
-          if (packet == NULL)
+          if (cross_shard)
+          {
+            gearman_server_shard_lock_all(Server);
+          }
+          else
           {
-            break;
+            gearman_server_shard_lock(shard);
           }
 
           con->ret= gearman_server_run_command(con, &(packet->packet));
-          packet_sent = true;
-          gearmand_packet_free(&(packet->packet));
-          gearman_server_packet_free(packet, con->thread, false);
-        }
 
-        // if a packet was sent in above block, and connection is dead,
-        // queue up into io thread so it comes back to the PROC queue for
-        // marking proc_removed. this prevents leaking any connection objects
-        if (packet_sent)
-        {
-          if (con->is_dead)
+          if (cross_shard)
+          {
+            gearman_server_shard_unlock_all(Server);
+          }
+          else
           {
-            gearman_server_con_io_add(con);
+            gearman_server_shard_unlock(shard);
           }
+
+          gearmand_packet_free(&(packet->packet));
+          gearman_server_packet_free(packet, con->thread, false);
+          continue;
         }
-        else if (con->is_dead)
+
+        // The connection went away after everything it sent was run, its
+        // workers and clients may live in any shard.
+        if (is_dead)
         {
+          gearman_server_shard_lock_all(Server);
           gearman_server_con_free_workers(con);
 
           while (con->client_list != NULL)
+          {
             gearman_server_client_free(con->client_list);
+          }
+          gearman_server_shard_unlock_all(Server);
 
-          con->proc_removed= true;
-          gearman_server_con_to_be_freed_add(con);
+          gearman_server_con_proc_removed(con);
         }
+
+        // Either finished, or handed to the shard that owns the next packet.
+        break;
       }
     }
   }
 }
 
-gearman_server_job_st * gearman_server_job_create(gearman_server_st *server)
+gearman_server_job_st * gearman_server_job_create(gearman_server_shard_st *shard)
 {
   gearman_server_job_st *server_job;
 
-  if (server->free_job_count > 0)
+  if (shard->free_job_count > 0)
   {
-    server_job= server->free_job_list;
-    GEARMAND_LIST__DEL(server->free_job, server_job);
+    server_job= shard->free_job_list;
+    GEARMAND_LIST__DEL(shard->free_job, server_job);
   }
   else
   {
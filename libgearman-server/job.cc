@@ -63,32 +63,35 @@
  * Get a server job structure from the unique ID. If data_size is non-zero,
  * then unique points to the workload data and not a real unique key.
  */
-static gearman_server_job_st * _server_job_get_unique(gearman_server_st *server, uint32_t unique_key,
+static gearman_server_job_st * _server_job_get_unique(gearman_server_st *, uint32_t unique_key,
                                                       gearman_server_function_st *server_function,
                                                       const char *unique, size_t data_size)
 {
-  gearman_server_job_st *server_job;
+  gearman_server_job_table_st *table= &(server_function->shard->unique_table);
 
-  for (server_job= server->unique_hash[unique_key % server->hashtable_buckets];
-       server_job != NULL; server_job= server_job->unique_next)
+  for (uint32_t array= 0; array < 2; ++array)
   {
-    if (data_size == 0)
+    for (gearman_server_job_st *server_job= gearman_server_job_table_bucket(table, unique_key, array);
+         server_job != NULL; server_job= server_job->unique_next)
     {
-      if (server_job->function == server_function &&
-          server_job->unique_key == unique_key &&
-          !strcmp(server_job->unique, unique))
+      if (data_size == 0)
       {
-        return server_job;
+        if (server_job->function == server_function &&
+            server_job->unique_key == unique_key &&
+            !strcmp(server_job->unique, unique))
+        {
+          return server_job;
+        }
       }
-    }
-    else
-    {
-      if (server_job->function == server_function &&
-          server_job->unique_key == unique_key &&
-          server_job->data_size == data_size &&
-          memcmp(server_job->data, unique, data_size) == 0)
+      else
       {
-        return server_job;
+        if (server_job->function == server_function &&
+            server_job->unique_key == unique_key &&
+            server_job->data_size == data_size &&
+            memcmp(server_job->data, unique, data_size) == 0)
+        {
+          return server_job;
+        }
       }
     }
   }
@@ -182,7 +185,8 @@ gearman_server_job_add_reducer(gearman_server_st *server,
       return NULL;
     }
 
-    server_job= gearman_server_job_create(server);
+    gearman_server_shard_st *shard= server_function->shard;
+    server_job= gearman_server_job_create(shard);
     if (server_job == NULL)
     {
       *ret_ptr= GEARMAND_MEMORY_ALLOCATION_FAILURE;
@@ -194,14 +198,18 @@ gearman_server_job_add_reducer(gearman_server_st *server,
     server_job->function= server_function;
     server_function->job_total++;
 
+    /* The handle is kept congruent to the shard index so that later commands
+       naming the handle can be routed to the owning shard. */
+    uint64_t job_handle_id= uint64_t(shard->job_handle_count) * server->shard_count + shard->index;
+
     int checked_length;
-    checked_length= snprintf(server_job->job_handle, GEARMAND_JOB_HANDLE_SIZE, "%s:%u",
-                             server->job_handle_prefix, server->job_handle_count);
+    checked_length= snprintf(server_job->job_handle, GEARMAND_JOB_HANDLE_SIZE, "%s:%" PRIu64,
+                             server->job_handle_prefix, job_handle_id);
 
     if (checked_length >= GEARMAND_JOB_HANDLE_SIZE || checked_length < 0)
     {
-      gearmand_log_error(GEARMAN_DEFAULT_LOG_PARAM, "Job handle plus handle count beyond GEARMAND_JOB_HANDLE_SIZE: %s:%u",
-                         server->job_handle_prefix, server->job_handle_count);
+      gearmand_log_error(GEARMAN_DEFAULT_LOG_PARAM, "Job handle plus handle count beyond GEARMAND_JOB_HANDLE_SIZE: %s:%" PRIu64,
+                         server->job_handle_prefix, job_handle_id);
     }
 
     server_job->unique_length= unique_size;
@@ -212,7 +220,7 @@ gearman_server_job_add_reducer(gearman_server_st *server,
       gearmand_log_error(GEARMAN_DEFAULT_LOG_PARAM, "We received a unique beyond GEARMAN_MAX_UNIQUE_SIZE: %.*s", (int)unique_size, unique);
     }
 
-    server->job_handle_count++;
+    shard->job_handle_count++;
     server_job->data= data;
     server_job->data_size= data_size;
 		server_job->when= when; 
@@ -228,14 +236,12 @@ gearman_server_job_add_reducer(gearman_server_st *server,
     }
 		
     server_job->unique_key= key;
-    key= key % server->hashtable_buckets;
-    GEARMAND_HASH_ADD(server->unique, key, server_job, unique_);
+    gearman_server_job_table_add(&(shard->unique_table), key, server_job);
 
     key= _server_job_hash(server_job->job_handle,
                           strlen(server_job->job_handle));
     server_job->job_handle_key= key;
-    key= key % server->hashtable_buckets;
-    GEARMAND_HASH__ADD(server->job, key, server_job);
+    gearman_server_job_table_add(&(shard->job_table), key, server_job);
 
     gearmand_log_debug(GEARMAN_DEFAULT_LOG_PARAM, "JOB %s :%u",
                        server_job->job_handle, server_job->job_handle_key);
@@ -319,16 +325,14 @@ void gearman_server_job_free(gearman_server_job_st *server_job)
       GEARMAND_LIST_DEL(server_job->worker->job, server_job, worker_);
     }
 
-    uint32_t key= server_job->unique_key % Server->hashtable_buckets;
-    GEARMAND_HASH_DEL(Server->unique, key, server_job, unique_);
+    gearman_server_shard_st *shard= server_job->function->shard;
 
-    key= server_job->job_handle_key % Server->hashtable_buckets;
-    GEARMAND_HASH__DEL(Server->job, key, server_job);
+    gearman_server_job_table_del(&(shard->unique_table), server_job->unique_key, server_job);
+    gearman_server_job_table_del(&(shard->job_table), server_job->job_handle_key, server_job);
 
-    if (Server->free_job_count < GEARMAND_MAX_FREE_SERVER_JOB)
+    if (shard->free_job_count < GEARMAND_MAX_FREE_SERVER_JOB)
     {
-      gearman_server_st *server= Server;
-      GEARMAND_LIST__ADD(server->free_job, server_job);
+      GEARMAND_LIST__ADD(shard->free_job, server_job);
     }
     else
     {
@@ -91,7 +91,7 @@ gearman_server_job_add_reducer(gearman_server_st *server,
  */
 GEARMAN_API
 gearman_server_job_st *
-gearman_server_job_create(gearman_server_st *server);
+gearman_server_job_create(gearman_server_shard_st *shard);
 
 /**
  * Free a server job structure.
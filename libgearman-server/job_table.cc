@@ -0,0 +1,335 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ * 
+ *  Gearmand client and server library.
+ *
+ *  Copyright (C) 2011 Data Differential, http://datadifferential.com/
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *      * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *
+ *      * Redistributions in binary form must reproduce the above
+ *  copyright notice, this list of conditions and the following disclaimer
+ *  in the documentation and/or other materials provided with the
+ *  distribution.
+ *
+ *      * The names of its contributors may not be used to endorse or
+ *  promote products derived from this software without specific prior
+ *  written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/**
+ * @file
+ * @brief Job hash table definitions
+ */
+
+#include "gear_config.h"
+#include "libgearman-server/common.h"
+
+#include <cassert>
+#include <cstring>
+
+#pragma GCC diagnostic push
+#ifndef __INTEL_COMPILER
+# pragma GCC diagnostic ignored "-Wold-style-cast"
+#endif
+
+/*
+ * Private declarations
+ */
+
+/* Number of non-empty buckets moved by each add or delete during a rehash. */
+#define GEARMAND_JOB_TABLE_REHASH_STEP 4
+
+/* Grow when there is more than one job per bucket, shrink below one in eight. */
+#define GEARMAND_JOB_TABLE_SHRINK_RATIO 8
+
+static inline gearman_server_job_st *&_table_next(const gearman_server_job_table_st *table,
+                                                  gearman_server_job_st *job)
+{
+  return table->unique ? job->unique_next : job->next;
+}
+
+static inline gearman_server_job_st *&_table_prev(const gearman_server_job_table_st *table,
+                                                  gearman_server_job_st *job)
+{
+  return table->unique ? job->unique_prev : job->prev;
+}
+
+static inline uint32_t _table_key(const gearman_server_job_table_st *table,
+                                  const gearman_server_job_st *job)
+{
+  return table->unique ? job->unique_key : job->job_handle_key;
+}
+
+static inline bool _table_rehashing(const gearman_server_job_table_st *table)
+{
+  return table->bucket[1] != NULL;
+}
+
+static void _table_link(gearman_server_job_table_st *table,
+                        gearman_server_job_st **bucket,
+                        gearman_server_job_st *job)
+{
+  if (*bucket != NULL)
+  {
+    _table_prev(table, *bucket)= job;
+  }
+  _table_next(table, job)= *bucket;
+  _table_prev(table, job)= NULL;
+  *bucket= job;
+}
+
+/**
+ * Move up to steps non-empty buckets from the old array to the new one.
+ */
+static void _table_rehash(gearman_server_job_table_st *table, uint32_t steps)
+{
+  uint32_t empty_visits= steps * 10;
+
+  while (steps-- and _table_rehashing(table))
+  {
+    while (table->rehash_index < table->size[0] and
+           table->bucket[0][table->rehash_index] == NULL)
+    {
+      table->rehash_index++;
+      if (--empty_visits == 0)
+      {
+        return;
+      }
+    }
+
+    if (table->rehash_index < table->size[0])
+    {
+      gearman_server_job_st *job= table->bucket[0][table->rehash_index];
+      while (job != NULL)
+      {
+        gearman_server_job_st *next= _table_next(table, job);
+        _table_link(table, &table->bucket[1][_table_key(table, job) % table->size[1]], job);
+        job= next;
+      }
+      table->bucket[0][table->rehash_index]= NULL;
+      table->rehash_index++;
+    }
+
+    if (table->rehash_index >= table->size[0])
+    {
+      free(table->bucket[0]);
+      table->bucket[0]= table->bucket[1];
+      table->size[0]= table->size[1];
+      table->bucket[1]= NULL;
+      table->size[1]= 0;
+      table->rehash_index= 0;
+      table->resize_count++;
+    }
+  }
+}
+
+/**
+ * Start moving to a bucket array of new_size, if it can be allocated.
+ */
+static void _table_resize(gearman_server_job_table_st *table, uint32_t new_size)
+{
+  gearman_server_job_st **bucket= (gearman_server_job_st **) calloc(new_size, sizeof(gearman_server_job_st *));
+  if (bucket == NULL)
+  {
+    /* The table still works with longer chains, so just try again later. */
+    gearmand_merror("calloc", gearman_server_job_st *, new_size);
+    return;
+  }
+
+  gearmand_log_debug(GEARMAN_DEFAULT_LOG_PARAM, "Resizing %s table from %u to %u buckets for %u jobs",
+                     table->unique ? "unique" : "job handle",
+                     table->size[0], new_size, table->count);
+
+  table->bucket[1]= bucket;
+  table->size[1]= new_size;
+  table->rehash_index= 0;
+}
+
+static void _table_maintain(gearman_server_job_table_st *table)
+{
+  if (table->pause)
+  {
+    return;
+  }
+
+  if (_table_rehashing(table))
+  {
+    _table_rehash(table, GEARMAND_JOB_TABLE_REHASH_STEP);
+    return;
+  }
+
+  if (table->count > table->size[0] and table->size[0] <= UINT32_MAX / 2)
+  {
+    _table_resize(table, table->size[0] * 2);
+  }
+  else if (table->size[0] > table->min_size and
+           table->count < table->size[0] / GEARMAND_JOB_TABLE_SHRINK_RATIO)
+  {
+    uint32_t new_size= table->size[0] / 2;
+    _table_resize(table, new_size < table->min_size ? table->min_size : new_size);
+  }
+}
+
+/*
+ * Public definitions
+ */
+
+bool gearman_server_job_table_init(gearman_server_job_table_st *table,
+                                   uint32_t min_size, bool unique)
+{
+  assert(min_size);
+  table->unique= unique;
+  table->min_size= min_size;
+  table->bucket[0]= (gearman_server_job_st **) calloc(min_size, sizeof(gearman_server_job_st *));
+  if (table->bucket[0] == NULL)
+  {
+    gearmand_merror("calloc", gearman_server_job_st *, min_size);
+    return false;
+  }
+  table->size[0]= min_size;
+
+  return true;
+}
+
+void gearman_server_job_table_free(gearman_server_job_table_st *table)
+{
+  free(table->bucket[0]);
+  free(table->bucket[1]);
+  table->bucket[0]= table->bucket[1]= NULL;
+  table->size[0]= table->size[1]= 0;
+  table->count= 0;
+}
+
+void gearman_server_job_table_add(gearman_server_job_table_st *table,
+                                  uint32_t key,
+                                  gearman_server_job_st *job)
+{
+  _table_maintain(table);
+
+  /* New jobs go straight into the new array while a rehash is running. */
+  if (_table_rehashing(table))
+  {
+    _table_link(table, &table->bucket[1][key % table->size[1]], job);
+  }
+  else
+  {
+    _table_link(table, &table->bucket[0][key % table->size[0]], job);
+  }
+  table->count++;
+}
+
+void gearman_server_job_table_del(gearman_server_job_table_st *table,
+                                  uint32_t key,
+                                  gearman_server_job_st *job)
+{
+  gearman_server_job_st **head= &table->bucket[0][key % table->size[0]];
+  if (*head != job and _table_rehashing(table))
+  {
+    head= &table->bucket[1][key % table->size[1]];
+  }
+
+  if (*head == job)
+  {
+    *head= _table_next(table, job);
+  }
+
+  if (_table_prev(table, job) != NULL)
+  {
+    _table_next(table, _table_prev(table, job))= _table_next(table, job);
+  }
+
+  if (_table_next(table, job) != NULL)
+  {
+    _table_prev(table, _table_next(table, job))= _table_prev(table, job);
+  }
+  table->count--;
+
+  _table_maintain(table);
+}
+
+gearman_server_job_st *gearman_server_job_table_bucket(gearman_server_job_table_st *table,
+                                                       uint32_t key,
+                                                       uint32_t array)
+{
+  if (array == 0)
+  {
+    return table->bucket[0][key % table->size[0]];
+  }
+
+  if (array == 1 and _table_rehashing(table))
+  {
+    return table->bucket[1][key % table->size[1]];
+  }
+
+  return NULL;
+}
+
+void gearman_server_job_table_pause(gearman_server_job_table_st *table)
+{
+  table->pause++;
+}
+
+void gearman_server_job_table_resume(gearman_server_job_table_st *table)
+{
+  assert(table->pause);
+  table->pause--;
+}
+
+void gearman_server_job_table_stat(const gearman_server_job_table_st *table,
+                                   gearman_server_job_table_stat_st *stat)
+{
+  memset(stat, 0, sizeof(gearman_server_job_table_stat_st));
+  stat->count= table->count;
+  stat->resize_count= table->resize_count;
+  stat->rehashing= _table_rehashing(table);
+
+  for (uint32_t array= 0; array < 2; ++array)
+  {
+    if (table->bucket[array] == NULL)
+    {
+      continue;
+    }
+
+    stat->buckets+= table->size[array];
+    for (uint32_t x= 0; x < table->size[array]; ++x)
+    {
+      uint32_t chain= 0;
+      for (gearman_server_job_st *job= table->bucket[array][x]; job != NULL;
+           job= _table_next(table, job))
+      {
+        chain++;
+      }
+
+      if (chain)
+      {
+        stat->used_buckets++;
+        if (chain > stat->max_chain)
+        {
+          stat->max_chain= chain;
+        }
+      }
+    }
+  }
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,127 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ * 
+ *  Gearmand client and server library.
+ *
+ *  Copyright (C) 2011 Data Differential, http://datadifferential.com/
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *      * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *
+ *      * Redistributions in binary form must reproduce the above
+ *  copyright notice, this list of conditions and the following disclaimer
+ *  in the documentation and/or other materials provided with the
+ *  distribution.
+ *
+ *      * The names of its contributors may not be used to endorse or
+ *  promote products derived from this software without specific prior
+ *  written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/**
+ * @file
+ * @brief Job hash table declarations
+ */
+
+#pragma once
+
+#include <libgearman-server/struct/job_table.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup gearman_server_job_table Job hash table declarations
+ * @ingroup gearman_server
+ *
+ * Jobs are indexed by job handle and by unique key in tables that start at
+ * --hashtable-buckets buckets, grow once there is more than one job per
+ * bucket and shrink again when they are mostly empty. The rehash is spread
+ * over the following adds and deletes.
+ *
+ * @{
+ */
+
+/**
+ * Allocate the buckets of a table. If unique is true the table chains jobs
+ * through their unique links, otherwise through their job handle links.
+ */
+bool gearman_server_job_table_init(gearman_server_job_table_st *table,
+                                   uint32_t min_size, bool unique);
+
+/**
+ * Free the buckets of a table. The jobs themselves are not touched.
+ */
+void gearman_server_job_table_free(gearman_server_job_table_st *table);
+
+/**
+ * Add a job, hashed by key.
+ */
+void gearman_server_job_table_add(gearman_server_job_table_st *table,
+                                  uint32_t key,
+                                  gearman_server_job_st *job);
+
+/**
+ * Remove a job that was added with key.
+ */
+void gearman_server_job_table_del(gearman_server_job_table_st *table,
+                                  uint32_t key,
+                                  gearman_server_job_st *job);
+
+/**
+ * First job of the chain for key in one of the two bucket arrays (0 or 1).
+ * Array 1 is only in use while a rehash is running, NULL is returned
+ * otherwise.
+ */
+gearman_server_job_st *gearman_server_job_table_bucket(gearman_server_job_table_st *table,
+                                                       uint32_t key,
+                                                       uint32_t array);
+
+/**
+ * Stop the table from moving jobs between buckets, so that it can be walked
+ * while jobs are being removed from it.
+ */
+void gearman_server_job_table_pause(gearman_server_job_table_st *table);
+
+void gearman_server_job_table_resume(gearman_server_job_table_st *table);
+
+/**
+ * Chain length statistics, for the admin protocol.
+ */
+struct gearman_server_job_table_stat_st
+{
+  uint32_t count;
+  uint32_t buckets;
+  uint32_t used_buckets;
+  uint32_t max_chain;
+  uint64_t resize_count;
+  bool rehashing;
+};
+
+void gearman_server_job_table_stat(const gearman_server_job_table_st *table,
+                                   gearman_server_job_table_stat_st *stat);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
@@ -75,7 +75,7 @@ gearman_server_packet_create(gearman_server_thread_st *thread,
       thread->free_packet_count--;
     }
   }
-  else
+  else if (Server->shard_count == 1)
   {
     if (Server->free_packet_count > 0)
     {
@@ -122,7 +122,7 @@ void gearman_server_packet_free(gearman_server_packet_st *packet,
       delete packet;
     }
   }
-  else
+  else if (Server->shard_count == 1)
   {
     if (Server->free_packet_count < GEARMAND_MAX_FREE_SERVER_PACKET)
     {
@@ -135,6 +135,11 @@ void gearman_server_packet_free(gearman_server_packet_st *packet,
       delete packet;
     }
   }
+  else
+  {
+    /* The server free list is not shared between processing threads. */
+    delete packet;
+  }
 }
 
 gearmand_error_t gearman_server_io_packet_add(gearman_server_con_st *con,
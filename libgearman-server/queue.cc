@@ -49,6 +49,52 @@
 
 #include <assert.h>
 
+/**
+ * Queue plugins are not written to be called from more than one processing
+ * thread at a time, so calls into them are serialized once the job engine
+ * is split into shards.
+ */
+static void _queue_lock(gearman_server_st *server)
+{
+  if (server->shard_count > 1)
+  {
+    int pthread_error;
+    if ((pthread_error= pthread_mutex_lock(&(server->queue_lock))))
+    {
+      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_lock");
+    }
+  }
+}
+
+static void _queue_unlock(gearman_server_st *server)
+{
+  if (server->shard_count > 1)
+  {
+    int pthread_error;
+    if ((pthread_error= pthread_mutex_unlock(&(server->queue_lock))))
+    {
+      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_unlock");
+    }
+  }
+}
+
+static gearmand_error_t _queue_flush(gearman_server_st *server)
+{
+  if (server->queue_version != QUEUE_VERSION_NONE)
+  {
+    if (server->queue_version == QUEUE_VERSION_FUNCTION)
+    {
+      assert(server->queue.functions->_flush_fn);
+      return (*(server->queue.functions->_flush_fn))(server, (void *)server->queue.functions->_context);
+    }
+
+    assert(server->queue.object);
+    return server->queue.object->flush(server);
+  }
+
+  return GEARMAND_SUCCESS;
+}
+
 gearmand_error_t gearman_queue_add(gearman_server_st *server,
                                    const char *unique,
                                    size_t unique_size,
@@ -65,7 +111,9 @@ gearmand_error_t gearman_queue_add(gearman_server_st *server,
   {
     return GEARMAND_SUCCESS;
   }
-  else if (server->queue_version == QUEUE_VERSION_FUNCTION)
+
+  _queue_lock(server);
+  if (server->queue_version == QUEUE_VERSION_FUNCTION)
   {
     assert(server->queue.functions->_add_fn);
     ret= (*(server->queue.functions->_add_fn))(server,
@@ -89,27 +137,20 @@ gearmand_error_t gearman_queue_add(gearman_server_st *server,
 
   if (gearmand_success(ret))
   {
-    ret= gearman_queue_flush(server);
+    ret= _queue_flush(server);
   }
+  _queue_unlock(server);
 
   return ret;
 }
 
 gearmand_error_t gearman_queue_flush(gearman_server_st *server)
 {
-  if (server->queue_version != QUEUE_VERSION_NONE)
-  {
-    if (server->queue_version == QUEUE_VERSION_FUNCTION)
-    {
-      assert(server->queue.functions->_flush_fn);
-      return (*(server->queue.functions->_flush_fn))(server, (void *)server->queue.functions->_context);
-    }
-
-    assert(server->queue.object);
-    return server->queue.object->flush(server);
-  }
+  _queue_lock(server);
+  gearmand_error_t ret= _queue_flush(server);
+  _queue_unlock(server);
 
-  return GEARMAND_SUCCESS;
+  return ret;
 }
 
 gearmand_error_t gearman_queue_done(gearman_server_st *server,
@@ -122,23 +163,29 @@ gearmand_error_t gearman_queue_done(gearman_server_st *server,
   {
     return GEARMAND_SUCCESS;
   }
-  else if (server->queue_version == QUEUE_VERSION_FUNCTION)
+
+  gearmand_error_t ret;
+  _queue_lock(server);
+  if (server->queue_version == QUEUE_VERSION_FUNCTION)
   {
     assert(server->queue.functions->_done_fn);
-    return (*(server->queue.functions->_done_fn))(server,
-                                                  (void *)server->queue.functions->_context,
-                                                  unique, unique_size,
-                                                  function_name,
-                                                  function_name_size);
+    ret= (*(server->queue.functions->_done_fn))(server,
+                                                (void *)server->queue.functions->_context,
+                                                unique, unique_size,
+                                                function_name,
+                                                function_name_size);
   }
   else
   {
     assert(server->queue.object);
-    return server->queue.object->done(server,
-                                      unique, unique_size,
-                                      function_name,
-                                      function_name_size);
+    ret= server->queue.object->done(server,
+                                    unique, unique_size,
+                                    function_name,
+                                    function_name_size);
   }
+  _queue_unlock(server);
+
+  return ret;
 }
 
 void gearman_server_save_job(gearman_server_st& server,
@@ -935,7 +935,7 @@ gearmand_error_t gearman_server_shutdown_graceful(gearman_server_st *server)
 {
   server->shutdown_graceful= true;
 
-  if (server->job_count == 0)
+  if (gearman_server_shard_job_count(server) == 0)
   {
     return GEARMAND_SHUTDOWN;
   }
@@ -0,0 +1,382 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ * 
+ *  Gearmand client and server library.
+ *
+ *  Copyright (C) 2011 Data Differential, http://datadifferential.com/
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *      * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *
+ *      * Redistributions in binary form must reproduce the above
+ *  copyright notice, this list of conditions and the following disclaimer
+ *  in the documentation and/or other materials provided with the
+ *  distribution.
+ *
+ *      * The names of its contributors may not be used to endorse or
+ *  promote products derived from this software without specific prior
+ *  written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/**
+ * @file
+ * @brief Shard definitions
+ */
+
+#include "gear_config.h"
+#include "libgearman-server/common.h"
+
+#include <cassert>
+#include <cstring>
+#include <memory>
+
+#pragma GCC diagnostic push
+#ifndef __INTEL_COMPILER
+# pragma GCC diagnostic ignored "-Wold-style-cast"
+#endif
+
+/*
+ * Private declarations
+ */
+
+/**
+ * Arguments that are followed by another argument carry their terminating
+ * NULL in their size, the last argument does not.
+ */
+static inline size_t _shard_arg_length(const char *arg, size_t arg_size)
+{
+  if (arg_size and arg[arg_size -1] == 0)
+  {
+    return arg_size -1;
+  }
+
+  return arg_size;
+}
+
+/*
+ * Public definitions
+ */
+
+bool gearman_server_shard_create(gearman_server_st *server,
+                                 uint32_t shard_count,
+                                 uint32_t hashtable_buckets)
+{
+  assert(shard_count);
+  server->shard_list= new (std::nothrow) gearman_server_shard_st[shard_count];
+  if (server->shard_list == NULL)
+  {
+    gearmand_merror("new", gearman_server_shard_st, shard_count);
+    return false;
+  }
+  server->shard_count= shard_count;
+
+  for (uint32_t x= 0; x < shard_count; ++x)
+  {
+    gearman_server_shard_st *shard= &server->shard_list[x];
+
+    shard->index= x;
+    shard->job_handle_count= 1;
+
+    shard->function_hash= (gearman_server_function_st **) calloc(GEARMAND_DEFAULT_HASH_SIZE, sizeof(gearman_server_function_st *));
+    if (shard->function_hash == NULL)
+    {
+      gearmand_merror("calloc", shard->function_hash, GEARMAND_DEFAULT_HASH_SIZE);
+      gearman_server_shard_free(server);
+      return false;
+    }
+
+    if (gearman_server_job_table_init(&(shard->job_table), hashtable_buckets, false) == false or
+        gearman_server_job_table_init(&(shard->unique_table), hashtable_buckets, true) == false)
+    {
+      gearman_server_shard_free(server);
+      return false;
+    }
+
+    int pthread_error;
+    if ((pthread_error= pthread_mutex_init(&(shard->lock), NULL)) or
+        (pthread_error= pthread_mutex_init(&(shard->proc_lock), NULL)))
+    {
+      gearmand_perror(pthread_error, "pthread_mutex_init");
+      gearman_server_shard_free(server);
+      return false;
+    }
+
+    if ((pthread_error= pthread_cond_init(&(shard->proc_cond), NULL)))
+    {
+      gearmand_perror(pthread_error, "pthread_cond_init");
+      gearman_server_shard_free(server);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void gearman_server_shard_free(gearman_server_st *server)
+{
+  if (server->shard_list == NULL)
+  {
+    return;
+  }
+
+  for (uint32_t x= 0; x < server->shard_count; ++x)
+  {
+    gearman_server_shard_st *shard= &server->shard_list[x];
+
+    while (shard->free_job_list != NULL)
+    {
+      gearman_server_job_st* job= shard->free_job_list;
+      shard->free_job_list= job->next;
+      delete job;
+    }
+
+    while (shard->free_worker_list != NULL)
+    {
+      gearman_server_worker_st* worker= shard->free_worker_list;
+      shard->free_worker_list= worker->con_next;
+      delete worker;
+    }
+
+    free(shard->function_hash);
+    gearman_server_job_table_free(&(shard->job_table));
+    gearman_server_job_table_free(&(shard->unique_table));
+
+    pthread_cond_destroy(&(shard->proc_cond));
+    pthread_mutex_destroy(&(shard->proc_lock));
+    pthread_mutex_destroy(&(shard->lock));
+  }
+
+  delete [] server->shard_list;
+  server->shard_list= NULL;
+  server->shard_count= 0;
+}
+
+gearman_server_shard_st *gearman_server_shard_by_function(gearman_server_st *server,
+                                                          const char *function_name,
+                                                          size_t function_name_size)
+{
+  if (server->shard_count == 1)
+  {
+    return server->shard_list;
+  }
+
+  /* Use the high bits so that the bucket picked inside of the shard is not
+     correlated with the shard itself. */
+  uint64_t hash= _server_function_hash(function_name, function_name_size);
+  return &server->shard_list[(hash * server->shard_count) >> 32];
+}
+
+gearman_server_shard_st *gearman_server_shard_by_job_handle(gearman_server_st *server,
+                                                            const char *job_handle,
+                                                            size_t job_handle_length)
+{
+  if (server->shard_count == 1)
+  {
+    return server->shard_list;
+  }
+
+  /* Job handles end in a counter that was picked to be congruent to the
+     index of the shard modulo the number of shards. */
+  const char *end= job_handle + _shard_arg_length(job_handle, job_handle_length);
+  const char *ptr= end;
+  while (ptr > job_handle and ptr[-1] >= '0' and ptr[-1] <= '9')
+  {
+    --ptr;
+  }
+
+  uint64_t id= 0;
+  for (; ptr < end; ++ptr)
+  {
+    id= (id * 10) + uint64_t(*ptr - '0');
+  }
+
+  return &server->shard_list[id % server->shard_count];
+}
+
+gearman_server_shard_st *gearman_server_shard_route(gearman_server_st *server,
+                                                    gearman_server_con_st *con,
+                                                    gearmand_packet_st *packet,
+                                                    gearman_server_shard_st *current,
+                                                    bool *cross_shard)
+{
+  *cross_shard= false;
+
+  if (server->shard_count == 1)
+  {
+    return server->shard_list;
+  }
+
+  if (current == NULL)
+  {
+    current= server->shard_list;
+  }
+
+  switch (packet->command)
+  {
+  /* Commands that name a function. */
+  case GEARMAN_COMMAND_SUBMIT_JOB:
+  case GEARMAN_COMMAND_SUBMIT_JOB_BG:
+  case GEARMAN_COMMAND_SUBMIT_JOB_HIGH:
+  case GEARMAN_COMMAND_SUBMIT_JOB_HIGH_BG:
+  case GEARMAN_COMMAND_SUBMIT_JOB_LOW:
+  case GEARMAN_COMMAND_SUBMIT_JOB_LOW_BG:
+  case GEARMAN_COMMAND_SUBMIT_JOB_EPOCH:
+  case GEARMAN_COMMAND_SUBMIT_REDUCE_JOB:
+  case GEARMAN_COMMAND_SUBMIT_REDUCE_JOB_BACKGROUND:
+  case GEARMAN_COMMAND_CAN_DO:
+  case GEARMAN_COMMAND_CAN_DO_TIMEOUT:
+  case GEARMAN_COMMAND_CANT_DO:
+    if (packet->argc)
+    {
+      return gearman_server_shard_by_function(server, packet->arg[0],
+                                              _shard_arg_length(packet->arg[0], packet->arg_size[0]));
+    }
+    break;
+
+  /* Commands that name a job handle. */
+  case GEARMAN_COMMAND_GET_STATUS:
+  case GEARMAN_COMMAND_WORK_DATA:
+  case GEARMAN_COMMAND_WORK_WARNING:
+  case GEARMAN_COMMAND_WORK_STATUS:
+  case GEARMAN_COMMAND_WORK_COMPLETE:
+  case GEARMAN_COMMAND_WORK_EXCEPTION:
+  case GEARMAN_COMMAND_WORK_FAIL:
+    if (packet->argc)
+    {
+      return gearman_server_shard_by_job_handle(server, packet->arg[0], packet->arg_size[0]);
+    }
+    break;
+
+  /* Commands that look at every function a worker has registered. */
+  case GEARMAN_COMMAND_GRAB_JOB:
+  case GEARMAN_COMMAND_GRAB_JOB_UNIQ:
+  case GEARMAN_COMMAND_GRAB_JOB_ALL:
+  case GEARMAN_COMMAND_PRE_SLEEP:
+  case GEARMAN_COMMAND_RESET_ABILITIES:
+    {
+      gearman_server_shard_st *shard= NULL;
+      for (gearman_server_worker_st *worker= con->worker_list; worker != NULL; worker= worker->con_next)
+      {
+        if (shard == NULL)
+        {
+          shard= worker->function->shard;
+        }
+        else if (shard != worker->function->shard)
+        {
+          *cross_shard= true;
+          break;
+        }
+      }
+
+      if (shard)
+      {
+        return shard;
+      }
+    }
+    break;
+
+  /* Commands that search or report on every shard. */
+  case GEARMAN_COMMAND_GET_STATUS_UNIQUE:
+  case GEARMAN_COMMAND_TEXT:
+    *cross_shard= true;
+    break;
+
+  /* Commands that only touch the connection itself. */
+  case GEARMAN_COMMAND_ECHO_REQ:
+  case GEARMAN_COMMAND_SET_CLIENT_ID:
+  case GEARMAN_COMMAND_OPTION_REQ:
+    break;
+
+  /* Commands the server does not expect, they are rejected wherever they run. */
+  case GEARMAN_COMMAND_UNUSED:
+  case GEARMAN_COMMAND_NOOP:
+  case GEARMAN_COMMAND_JOB_CREATED:
+  case GEARMAN_COMMAND_NO_JOB:
+  case GEARMAN_COMMAND_JOB_ASSIGN:
+  case GEARMAN_COMMAND_ECHO_RES:
+  case GEARMAN_COMMAND_ERROR:
+  case GEARMAN_COMMAND_STATUS_RES:
+  case GEARMAN_COMMAND_ALL_YOURS:
+  case GEARMAN_COMMAND_OPTION_RES:
+  case GEARMAN_COMMAND_SUBMIT_JOB_SCHED:
+  case GEARMAN_COMMAND_JOB_ASSIGN_UNIQ:
+  case GEARMAN_COMMAND_JOB_ASSIGN_ALL:
+  case GEARMAN_COMMAND_STATUS_RES_UNIQUE:
+  case GEARMAN_COMMAND_MAX:
+  default:
+    break;
+  }
+
+  return current;
+}
+
+void gearman_server_shard_lock(gearman_server_shard_st *shard)
+{
+  if (Server->shard_count > 1)
+  {
+    int pthread_error;
+    if ((pthread_error= pthread_mutex_lock(&(shard->lock))))
+    {
+      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_lock");
+    }
+  }
+}
+
+void gearman_server_shard_unlock(gearman_server_shard_st *shard)
+{
+  if (Server->shard_count > 1)
+  {
+    int pthread_error;
+    if ((pthread_error= pthread_mutex_unlock(&(shard->lock))))
+    {
+      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, pthread_error, "pthread_mutex_unlock");
+    }
+  }
+}
+
+void gearman_server_shard_lock_all(gearman_server_st *server)
+{
+  for (uint32_t x= 0; x < server->shard_count; ++x)
+  {
+    gearman_server_shard_lock(&server->shard_list[x]);
+  }
+}
+
+void gearman_server_shard_unlock_all(gearman_server_st *server)
+{
+  for (uint32_t x= server->shard_count; x > 0; --x)
+  {
+    gearman_server_shard_unlock(&server->shard_list[x -1]);
+  }
+}
+
+uint32_t gearman_server_shard_job_count(gearman_server_st *server)
+{
+  uint32_t job_count= 0;
+  for (uint32_t x= 0; x < server->shard_count; ++x)
+  {
+    job_count+= server->shard_list[x].job_table.count;
+  }
+
+  return job_count;
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,124 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ * 
+ *  Gearmand client and server library.
+ *
+ *  Copyright (C) 2011 Data Differential, http://datadifferential.com/
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *      * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *
+ *      * Redistributions in binary form must reproduce the above
+ *  copyright notice, this list of conditions and the following disclaimer
+ *  in the documentation and/or other materials provided with the
+ *  distribution.
+ *
+ *      * The names of its contributors may not be used to endorse or
+ *  promote products derived from this software without specific prior
+ *  written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/**
+ * @file
+ * @brief Shard Declarations
+ */
+
+#pragma once
+
+#include <libgearman-server/struct/shard.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup gearman_server_shard Shard Declarations
+ * @ingroup gearman_server
+ *
+ * Functions are partitioned across shards by a hash of their name, and each
+ * shard is run by its own processing thread. Commands that name a function
+ * or a job handle run on the owning shard; commands that span several shards
+ * (admin commands, workers registered on functions of different shards,
+ * connection teardown) are run with every shard locked.
+ *
+ * @{
+ */
+
+/**
+ * Allocate the shards and their hash tables.
+ */
+bool gearman_server_shard_create(gearman_server_st *server,
+                                 uint32_t shard_count,
+                                 uint32_t hashtable_buckets);
+
+/**
+ * Free the shards. All jobs and functions must have been released already.
+ */
+void gearman_server_shard_free(gearman_server_st *server);
+
+/**
+ * Find the shard that owns a function.
+ */
+gearman_server_shard_st *gearman_server_shard_by_function(gearman_server_st *server,
+                                                          const char *function_name,
+                                                          size_t function_name_size);
+
+/**
+ * Find the shard that owns a job, as encoded in the job handle.
+ */
+gearman_server_shard_st *gearman_server_shard_by_job_handle(gearman_server_st *server,
+                                                            const char *job_handle,
+                                                            size_t job_handle_length);
+
+/**
+ * Decide which shard should run a packet for a connection. cross_shard is
+ * set if the command touches state owned by more than one shard.
+ */
+gearman_server_shard_st *gearman_server_shard_route(gearman_server_st *server,
+                                                    gearman_server_con_st *con,
+                                                    gearmand_packet_st *packet,
+                                                    gearman_server_shard_st *current,
+                                                    bool *cross_shard);
+
+/**
+ * Take ownership of a shard's state. Does nothing with a single shard.
+ */
+void gearman_server_shard_lock(gearman_server_shard_st *shard);
+
+void gearman_server_shard_unlock(gearman_server_shard_st *shard);
+
+/**
+ * Take ownership of every shard, in index order.
+ */
+void gearman_server_shard_lock_all(gearman_server_st *server);
+
+void gearman_server_shard_unlock_all(gearman_server_st *server);
+
+/**
+ * Total number of jobs known to the server.
+ */
+uint32_t gearman_server_shard_job_count(gearman_server_st *server);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
@@ -48,6 +48,7 @@ struct gearman_server_function_st
   gearman_server_function_st *next;
   gearman_server_function_st *prev;
   char *function_name;
+  struct gearman_server_shard_st *shard;
   gearman_server_worker_st *worker_list;
   struct gearman_server_job_st *job_list[GEARMAN_JOB_PRIORITY_MAX];
   gearman_server_job_st *job_end[GEARMAN_JOB_PRIORITY_MAX];
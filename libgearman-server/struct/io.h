@@ -151,7 +151,7 @@ struct gearman_server_con_st
   bool is_cleaned_up{};
   gearmand_error_t ret{};
   bool io_list{};
-  bool proc_list{};
+  bool proc_list{}; // Owned by a shard, either waiting or being run.
   bool proc_removed{};
   bool to_be_freed_list{};
   uint32_t io_packet_count{};
@@ -170,6 +170,7 @@ struct gearman_server_con_st
   gearman_server_con_st *io_prev{nullptr};
   gearman_server_con_st *proc_next{nullptr};
   gearman_server_con_st *proc_prev{nullptr};
+  struct gearman_server_shard_st *proc_shard{nullptr}; // Shard whose run list holds this connection.
   gearman_server_con_st *to_be_freed_next{nullptr};
   gearman_server_con_st *to_be_freed_prev{nullptr};
   struct gearman_server_worker_st *worker_list{nullptr};
@@ -37,6 +37,8 @@
 
 #pragma once
 
+#include "libgearman-server/struct/shard.h"
+
 struct queue_st {
   void *_context;
   gearman_queue_add_fn *_add_fn;
@@ -83,34 +85,22 @@ struct gearman_server_st
   } state;
   bool shutdown{};
   bool shutdown_graceful{};
-  bool proc_wakeup{};
   bool proc_shutdown{};
   uint32_t job_retries{}; // Set maximum job retry count.
   uint8_t worker_wakeup{}; // Set maximum number of workers to wake up per job.
-  uint32_t job_handle_count{};
   uint32_t thread_count{};
-  uint32_t function_count{};
-  uint32_t job_count{};
-  uint32_t unique_count{};
+  uint32_t shard_count{}; // Number of processing threads, see --proc-threads
   uint32_t free_packet_count{};
-  uint32_t free_job_count{};
   uint32_t free_client_count{};
-  uint32_t free_worker_count{};
   gearman_server_thread_st *thread_list{nullptr};
-  gearman_server_function_st **function_hash{nullptr};
+  gearman_server_shard_st *shard_list{nullptr};
   gearman_server_packet_st *free_packet_list{nullptr};
-  gearman_server_job_st *free_job_list{nullptr};
   gearman_server_client_st *free_client_list{nullptr};
-  gearman_server_worker_st *free_worker_list{nullptr};
   enum queue_version_t queue_version{};
   struct Queue_st queue{};
-  pthread_mutex_t proc_lock{};
-  pthread_cond_t proc_cond{};
-  pthread_t proc_id{};
+  pthread_mutex_t queue_lock{}; // Serializes the queue plugin between shards.
   char job_handle_prefix[GEARMAND_JOB_HANDLE_SIZE];
   uint32_t hashtable_buckets{};
-  gearman_server_job_st **job_hash{nullptr};
-  gearman_server_job_st **unique_hash{nullptr};
 
   gearman_server_st()
   {
@@ -0,0 +1,74 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ * 
+ *  Gearmand client and server library.
+ *
+ *  Copyright (C) 2011 Data Differential, http://datadifferential.com/
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *      * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *
+ *      * Redistributions in binary form must reproduce the above
+ *  copyright notice, this list of conditions and the following disclaimer
+ *  in the documentation and/or other materials provided with the
+ *  distribution.
+ *
+ *      * The names of its contributors may not be used to endorse or
+ *  promote products derived from this software without specific prior
+ *  written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#pragma once
+
+#include <pthread.h>
+
+#include "libgearman-server/struct/job_table.h"
+
+/*
+  A shard owns a disjoint subset of the server's functions, picked by hashing
+  the function name, and every job queued against those functions. Each shard
+  is run by its own processing thread. With a single shard (the default) this
+  is the classic single "proc" thread.
+*/
+struct gearman_server_shard_st
+{
+  uint32_t index{};
+  bool proc_wakeup{};
+  uint32_t function_count{};
+  uint32_t job_handle_count{};
+  uint32_t free_job_count{};
+  uint32_t free_worker_count{};
+  uint32_t con_count{};
+  struct gearman_server_function_st **function_hash{nullptr};
+  gearman_server_job_table_st job_table; // Jobs by job handle.
+  gearman_server_job_table_st unique_table; // Jobs by unique key.
+  struct gearman_server_job_st *free_job_list{nullptr};
+  struct gearman_server_worker_st *free_worker_list{nullptr};
+  struct gearman_server_con_st *con_list{nullptr}; // Connections waiting to be run.
+  pthread_mutex_t lock; // Owns the function and job state of the shard.
+  pthread_mutex_t proc_lock; // Protects con_list and proc_wakeup.
+  pthread_cond_t proc_cond;
+  pthread_t proc_id;
+
+  gearman_server_shard_st()
+  {
+  }
+};
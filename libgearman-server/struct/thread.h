@@ -43,7 +43,6 @@ struct gearman_server_thread_st
 {
   uint32_t con_count{};
   uint32_t io_count{};
-  uint32_t proc_count{};
   uint32_t to_be_freed_count{};
   uint32_t free_con_count{};
   uint32_t free_packet_count{};
@@ -56,7 +55,6 @@ struct gearman_server_thread_st
   void *run_fn_arg{nullptr};
   gearman_server_con_st *con_list{nullptr};
   gearman_server_con_st *io_list{nullptr};
-  gearman_server_con_st *proc_list{nullptr};
   gearman_server_con_st *free_con_list{nullptr};
   gearman_server_con_st *to_be_freed_list{nullptr};
   gearman_server_packet_st *free_packet_list{nullptr};
@@ -123,49 +123,57 @@ gearmand_error_t server_run_text(gearman_server_con_st *server_con,
   {
     uint32_t job_queued[GEARMAN_JOB_PRIORITY_MAX];
 
-    for (uint32_t function_key= 0;
-         function_key < GEARMAND_DEFAULT_HASH_SIZE;
-         function_key++)
+    for (uint32_t shard_key= 0; shard_key < Server->shard_count; ++shard_key)
     {
-      for (gearman_server_function_st *function= Server->function_hash[function_key];
-           function != NULL;
-           function= function->next)
+      gearman_server_shard_st *shard= &Server->shard_list[shard_key];
+      for (uint32_t function_key= 0;
+           function_key < GEARMAND_DEFAULT_HASH_SIZE;
+           function_key++)
       {
-        for (size_t priority = 0; priority < GEARMAN_JOB_PRIORITY_MAX; priority++)
+        for (gearman_server_function_st *function= shard->function_hash[function_key];
+             function != NULL;
+             function= function->next)
         {
-          job_queued[priority] = 0;
-          for (gearman_server_job_st *server_job= function->job_list[priority];
-               server_job != NULL;
-               server_job= server_job->next)
+          for (size_t priority = 0; priority < GEARMAN_JOB_PRIORITY_MAX; priority++)
           {
-            job_queued[priority]++;
+            job_queued[priority] = 0;
+            for (gearman_server_job_st *server_job= function->job_list[priority];
+                 server_job != NULL;
+                 server_job= server_job->next)
+            {
+              job_queued[priority]++;
+            }
           }
-        }
 
-        data.vec_append_printf("%.*s\t%u\t%u\t%u\t%u\n",
-                               int(function->function_name_size), function->function_name,
-                               job_queued[GEARMAN_JOB_PRIORITY_HIGH],
-                               job_queued[GEARMAN_JOB_PRIORITY_NORMAL],
-                               job_queued[GEARMAN_JOB_PRIORITY_LOW],
-                               function->worker_count);
+          data.vec_append_printf("%.*s\t%u\t%u\t%u\t%u\n",
+                                 int(function->function_name_size), function->function_name,
+                                 job_queued[GEARMAN_JOB_PRIORITY_HIGH],
+                                 job_queued[GEARMAN_JOB_PRIORITY_NORMAL],
+                                 job_queued[GEARMAN_JOB_PRIORITY_LOW],
+                                 function->worker_count);
+        }
       }
     }
     data.vec_append_printf(".\n");
   }
   else if (strcasecmp("status", (char *)(packet->arg[0])) == 0)
   {
-    for (uint32_t function_key= 0;
-         function_key < GEARMAND_DEFAULT_HASH_SIZE;
-         function_key++)
+    for (uint32_t shard_key= 0; shard_key < Server->shard_count; ++shard_key)
     {
-      for (gearman_server_function_st *function= Server->function_hash[function_key];
-           function != NULL;
-           function= function->next)
+      gearman_server_shard_st *shard= &Server->shard_list[shard_key];
+      for (uint32_t function_key= 0;
+           function_key < GEARMAND_DEFAULT_HASH_SIZE;
+           function_key++)
       {
-        data.vec_append_printf("%.*s\t%u\t%u\t%u\n",
-                               int(function->function_name_size),
-                               function->function_name, function->job_total,
-                               function->job_running, function->worker_count);
+        for (gearman_server_function_st *function= shard->function_hash[function_key];
+             function != NULL;
+             function= function->next)
+        {
+          data.vec_append_printf("%.*s\t%u\t%u\t%u\n",
+                                 int(function->function_name_size),
+                                 function->function_name, function->job_total,
+                                 function->job_running, function->worker_count);
+        }
       }
     }
     data.vec_append_printf(".\n");
@@ -198,13 +206,20 @@ gearmand_error_t server_run_text(gearman_server_con_st *server_con,
         and strcasecmp("unique", (char *)(packet->arg[1])) == 0
         and strcasecmp("jobs", (char *)(packet->arg[2])) == 0)
     {
-      for (size_t x= 0; x < Server->hashtable_buckets; x++)
+      for (uint32_t shard_key= 0; shard_key < Server->shard_count; ++shard_key)
       {
-        for (gearman_server_job_st* server_job= Server->unique_hash[x];
-             server_job != NULL;
-             server_job= server_job->unique_next)
+        gearman_server_job_table_st *table= &(Server->shard_list[shard_key].unique_table);
+        for (uint32_t array= 0; array < 2; ++array)
         {
-          data.vec_append_printf("%.*s\n", int(server_job->unique_length), server_job->unique);
+          for (size_t x= 0; table->bucket[array] and x < table->size[array]; x++)
+          {
+            for (gearman_server_job_st* server_job= table->bucket[array][x];
+                 server_job != NULL;
+                 server_job= server_job->unique_next)
+            {
+              data.vec_append_printf("%.*s\n", int(server_job->unique_length), server_job->unique);
+            }
+          }
         }
       }
 
@@ -213,14 +228,49 @@ gearmand_error_t server_run_text(gearman_server_con_st *server_con,
     else if (packet->argc == 2
              and strcasecmp("jobs", (char *)(packet->arg[1])) == 0)
     {
-      for (size_t x= 0; x < Server->hashtable_buckets; ++x)
+      for (uint32_t shard_key= 0; shard_key < Server->shard_count; ++shard_key)
       {
-        for (gearman_server_job_st *server_job= Server->job_hash[x];
-             server_job != NULL;
-             server_job= server_job->next)
+        gearman_server_job_table_st *table= &(Server->shard_list[shard_key].job_table);
+        for (uint32_t array= 0; array < 2; ++array)
         {
-          data.vec_append_printf("%s\t%u\t%u\t%u\n", server_job->job_handle, uint32_t(server_job->retries),
-                                 uint32_t(server_job->ignore_job), uint32_t(server_job->job_queued));
+          for (size_t x= 0; table->bucket[array] and x < table->size[array]; ++x)
+          {
+            for (gearman_server_job_st *server_job= table->bucket[array][x];
+                 server_job != NULL;
+                 server_job= server_job->next)
+            {
+              data.vec_append_printf("%s\t%u\t%u\t%u\n", server_job->job_handle, uint32_t(server_job->retries),
+                                     uint32_t(server_job->ignore_job), uint32_t(server_job->job_queued));
+            }
+          }
+        }
+      }
+
+      data.vec_append_printf(".\n");
+    }
+    else if (packet->argc == 2
+             and strcasecmp("hashtables", (char *)(packet->arg[1])) == 0)
+    {
+      // shard, table, entries, buckets, load factor, used buckets, longest
+      // chain, average chain, resizes, rehash in progress
+      for (uint32_t shard_key= 0; shard_key < Server->shard_count; ++shard_key)
+      {
+        gearman_server_shard_st *shard= &Server->shard_list[shard_key];
+        const gearman_server_job_table_st *tables[]= { &(shard->job_table), &(shard->unique_table) };
+        const char *table_names[]= { "job", "unique" };
+
+        for (size_t x= 0; x < gearmand_array_size(tables); ++x)
+        {
+          gearman_server_job_table_stat_st stat;
+          gearman_server_job_table_stat(tables[x], &stat);
+
+          data.vec_append_printf("%u\t%s\t%u\t%u\t%.2f\t%u\t%u\t%.2f\t%" PRIu64 "\t%u\n",
+                                 shard_key, table_names[x],
+                                 stat.count, stat.buckets,
+                                 stat.buckets ? double(stat.count) / double(stat.buckets) : 0.0,
+                                 stat.used_buckets, stat.max_chain,
+                                 stat.used_buckets ? double(stat.count) / double(stat.used_buckets) : 0.0,
+                                 stat.resize_count, uint32_t(stat.rehashing));
         }
       }
 
@@ -258,26 +308,30 @@ gearmand_error_t server_run_text(gearman_server_con_st *server_con,
     if (packet->argc == 3 and strcasecmp("function", (char *)(packet->arg[1])) == 0)
     {
       bool success= false;
-      for (uint32_t function_key= 0; function_key < GEARMAND_DEFAULT_HASH_SIZE;
-           function_key++)
+      for (uint32_t shard_key= 0; shard_key < Server->shard_count; ++shard_key)
       {
-        for (gearman_server_function_st *function= Server->function_hash[function_key];
-             function != NULL;
-             function= function->next)
+        gearman_server_shard_st *shard= &Server->shard_list[shard_key];
+        for (uint32_t function_key= 0; function_key < GEARMAND_DEFAULT_HASH_SIZE;
+             function_key++)
         {
-          if (strcasecmp(function->function_name, (char *)(packet->arg[2])) == 0)
+          for (gearman_server_function_st *function= shard->function_hash[function_key];
+               function != NULL;
+               function= function->next)
           {
-            success= true;
-            if (function->worker_count == 0 && function->job_running == 0)
-            {
-              gearman_server_function_free(Server, function);
-              data.vec_append_printf(TEXT_SUCCESS);
-            }
-            else
+            if (strcasecmp(function->function_name, (char *)(packet->arg[2])) == 0)
             {
-              data.vec_append_printf("ERR there are still connected workers or executing clients\r\n");
+              success= true;
+              if (function->worker_count == 0 && function->job_running == 0)
+              {
+                gearman_server_function_free(Server, function);
+                data.vec_append_printf(TEXT_SUCCESS);
+              }
+              else
+              {
+                data.vec_append_printf("ERR there are still connected workers or executing clients\r\n");
+              }
+              break;
             }
-            break;
           }
         }
       }
@@ -337,18 +391,22 @@ gearmand_error_t server_run_text(gearman_server_con_st *server_con,
         }
       }
        
-      for (uint32_t function_key= 0; function_key < GEARMAND_DEFAULT_HASH_SIZE;
-           function_key++)
+      for (uint32_t shard_key= 0; shard_key < Server->shard_count; ++shard_key)
       {
-        for (gearman_server_function_st *function= Server->function_hash[function_key];
-             function != NULL;
-             function= function->next)
+        gearman_server_shard_st *shard= &Server->shard_list[shard_key];
+        for (uint32_t function_key= 0; function_key < GEARMAND_DEFAULT_HASH_SIZE;
+             function_key++)
         {
-          if (strlen((char *)(packet->arg[1])) == function->function_name_size &&
-              (memcmp(packet->arg[1], function->function_name, function->function_name_size) == 0))
+          for (gearman_server_function_st *function= shard->function_hash[function_key];
+               function != NULL;
+               function= function->next)
           {
-            gearmand_log_debug(GEARMAN_DEFAULT_LOG_PARAM, "Applying queue limits to %s", function->function_name);
-            memcpy(function->max_queue_size, max_queue_size, sizeof(uint32_t) * GEARMAN_JOB_PRIORITY_MAX);
+            if (strlen((char *)(packet->arg[1])) == function->function_name_size &&
+                (memcmp(packet->arg[1], function->function_name, function->function_name_size) == 0))
+            {
+              gearmand_log_debug(GEARMAN_DEFAULT_LOG_PARAM, "Applying queue limits to %s", function->function_name);
+              memcpy(function->max_queue_size, max_queue_size, sizeof(uint32_t) * GEARMAN_JOB_PRIORITY_MAX);
+            }
           }
         }
       }
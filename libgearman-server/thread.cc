@@ -76,12 +76,12 @@ static gearmand_error_t _thread_packet_read(gearman_server_con_st *con);
 static gearmand_error_t _thread_packet_flush(gearman_server_con_st *con);
 
 /**
- * Start processing thread for the server.
+ * Start processing threads for the server, one per shard.
  */
 static gearmand_error_t _proc_thread_start(gearman_server_st *server);
 
 /**
- * Kill processing thread for the server.
+ * Kill processing threads for the server.
  */
 static void _proc_thread_kill(gearman_server_st *server);
 
@@ -110,7 +110,6 @@ bool gearman_server_thread_init(gearman_server_st *server,
 
   thread->con_count= 0;
   thread->io_count= 0;
-  thread->proc_count= 0;
   thread->to_be_freed_count= 0;
   thread->free_con_count= 0;
   thread->free_packet_count= 0;
@@ -120,7 +119,6 @@ bool gearman_server_thread_init(gearman_server_st *server,
   thread->run_fn_arg= NULL;
   thread->con_list= NULL;
   thread->io_list= NULL;
-  thread->proc_list= NULL;
   thread->free_con_list= NULL;
   thread->free_packet_list= NULL;
   thread->to_be_freed_list= NULL;
@@ -262,7 +260,7 @@ gearman_server_thread_run(gearman_server_thread_st *thread,
   }
   else if (Server->shutdown_graceful)
   {
-    if (Server->job_count == 0)
+    if (gearman_server_shard_job_count(Server) == 0)
     {
       *ret_ptr= GEARMAND_SHUTDOWN;
     }
@@ -367,16 +365,6 @@ static gearmand_error_t _thread_packet_flush(gearman_server_con_st *con)
 static gearmand_error_t _proc_thread_start(gearman_server_st *server)
 {
   int error;
-  if ((error= pthread_mutex_init(&(server->proc_lock), NULL)))
-  {
-    return gearmand_perror(error, "pthread_mutex_init");
-  }
-
-  if ((error= pthread_cond_init(&(server->proc_cond), NULL)))
-  {
-    return gearmand_perror(error, "pthread_cond_init");
-  }
-
   pthread_attr_t attr;
   if ((error= pthread_attr_init(&attr)))
   {
@@ -389,10 +377,26 @@ static gearmand_error_t _proc_thread_start(gearman_server_st *server)
     return gearmand_perror(error, "pthread_attr_setscope");
   }
 
-  if ((error= pthread_create(&(server->proc_id), &attr, _proc, server)))
+  /* One processing thread per shard. */
+  for (uint32_t x= 0; x < server->shard_count; ++x)
   {
-    (void) pthread_attr_destroy(&attr);
-    return gearmand_perror(error, "pthread_create");
+    gearman_server_shard_st *shard= &server->shard_list[x];
+    if ((error= pthread_create(&(shard->proc_id), &attr, _proc, shard)))
+    {
+      (void) pthread_attr_destroy(&attr);
+
+      /* Let the threads that did start go again. */
+      if (x)
+      {
+        uint32_t shard_count= server->shard_count;
+        server->shard_count= x;
+        server->flags.threaded= true;
+        _proc_thread_kill(server);
+        server->shard_count= shard_count;
+      }
+
+      return gearmand_perror(error, "pthread_create");
+    }
   }
 
   if ((error= pthread_attr_destroy(&attr)))
@@ -414,38 +418,35 @@ static void _proc_thread_kill(gearman_server_st *server)
 
   server->proc_shutdown= true;
 
-  /* Signal proc thread to shutdown. */
+  /* Signal proc threads to shutdown. */
   int error;
-  if ((error= pthread_mutex_lock(&(server->proc_lock))) == 0)
+  for (uint32_t x= 0; x < server->shard_count; ++x)
   {
-    if ((error= pthread_cond_signal(&(server->proc_cond))))
+    gearman_server_shard_st *shard= &server->shard_list[x];
+    if ((error= pthread_mutex_lock(&(shard->proc_lock))) == 0)
     {
-      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, error, "pthread_cond_signal");
-    }
+      if ((error= pthread_cond_signal(&(shard->proc_cond))))
+      {
+        gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, error, "pthread_cond_signal");
+      }
 
-    if ((error= pthread_mutex_unlock(&(server->proc_lock))))
+      if ((error= pthread_mutex_unlock(&(shard->proc_lock))))
+      {
+        gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, error, "pthread_mutex_unlock");
+      }
+    }
+    else
     {
-      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, error, "pthread_mutex_unlock");
+      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, error, "pthread_mutex_lock");
     }
   }
-  else
-  {
-    gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, error, "pthread_mutex_lock");
-  }
 
-  /* Wait for the proc thread to exit and then cleanup. */
-  if ((error= pthread_join(server->proc_id, NULL)))
+  /* Wait for the proc threads to exit, the shards clean up after them. */
+  for (uint32_t x= 0; x < server->shard_count; ++x)
   {
-    gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, error, "pthread_join");
-  }
-
-  if ((error= pthread_cond_destroy(&(server->proc_cond))))
-  {
-    gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, error, "pthread_cond_destroy");
-  }
-
-  if ((error= pthread_mutex_destroy(&(server->proc_lock))))
-  {
-    gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, error, "pthread_mutex_destroy");
+    if ((error= pthread_join(server->shard_list[x].proc_id, NULL)))
+    {
+      gearmand_log_fatal_perror(GEARMAN_DEFAULT_LOG_PARAM, error, "pthread_join");
+    }
   }
 }
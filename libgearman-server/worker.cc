@@ -49,11 +49,12 @@
 static gearman_server_worker_st* gearman_server_worker_create(gearman_server_con_st *con, gearman_server_function_st *function)
 {
   gearman_server_worker_st *worker;
+  gearman_server_shard_st *shard= function->shard;
 
-  if (Server->free_worker_count > 0)
+  if (shard->free_worker_count > 0)
   {
-    worker= Server->free_worker_list;
-    GEARMAND_LIST_DEL(Server->free_worker, worker, con_);
+    worker= shard->free_worker_list;
+    GEARMAND_LIST_DEL(shard->free_worker, worker, con_);
   }
   else
   {
@@ -148,9 +149,10 @@ void gearman_server_worker_free(gearman_server_worker_st *worker)
   }
   worker->function->worker_count--;
 
-  if (Server->free_worker_count < GEARMAND_MAX_FREE_SERVER_WORKER)
+  gearman_server_shard_st *shard= worker->function->shard;
+  if (shard->free_worker_count < GEARMAND_MAX_FREE_SERVER_WORKER)
   {
-    GEARMAND_LIST_ADD(Server->free_worker, worker, con_);
+    GEARMAND_LIST_ADD(shard->free_worker, worker, con_);
   }
   else
   {
@@ -502,6 +502,22 @@ static test_return_t hashtable_buckets_TEST(void *)
   return TEST_SUCCESS;
 }
 
+static test_return_t long_proc_threads_TEST(void *)
+{
+  const char *args[]= { "--check-args", "--proc-threads=4", 0 };
+
+  ASSERT_EQ(EXIT_SUCCESS, exec_cmdline(gearmand_binary(), args, true));
+  return TEST_SUCCESS;
+}
+
+static test_return_t long_proc_threads_ZERO_TEST(void *)
+{
+  const char *args[]= { "--check-args", "--proc-threads=0", 0 };
+
+  ASSERT_EQ(EXIT_FAILURE, exec_cmdline(gearmand_binary(), args, true));
+  return TEST_SUCCESS;
+}
+
 static test_return_t short_job_retries_test(void *)
 {
   const char *args[]= { "--check-args", "-j", "6", 0 };
@@ -636,6 +652,8 @@ test_st gearmand_option_tests[] ={
   {"-p", 0, short_port_test},
   {"--pid-file=", 0, long_pid_file_test},
   {"-P", 0, short_pid_file_test},
+  {"--proc-threads=", 0, long_proc_threads_TEST},
+  {"--proc-threads=0", 0, long_proc_threads_ZERO_TEST},
   {"--round-robin", 0, long_round_robin_test},
   {"-R", 0, short_round_robin_test},
   {"--ssl", 0, SSL_TEST},